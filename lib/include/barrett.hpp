@@ -0,0 +1,34 @@
+#pragma once
+
+#include "big_uint.hpp"
+#include "digit_vector.hpp"
+
+namespace big {
+
+/*
+ * Reduction by a fixed modulus m of n digits after P. Barrett "Implementing
+ * the RSA public key encryption algorithm on a standard digital signal
+ * processor". The scaled reciprocal floor(B^2n / m) is computed once, then
+ * reducing a number of up to 2n digits, such as a product of two residues,
+ * takes two multiplications and at most two subtractions of m. Unlike
+ * Montgomery form it works for even moduli as well.
+ */
+class barrett_context {
+    big_uint     _modulus;
+    // floor(B^2n / m).
+    digit_vector _mu;
+
+public:
+    // m > 0.
+    explicit barrett_context(const big_uint & m);
+
+    const big_uint & modulus() const { return _modulus; }
+
+    // x mod m. Numbers longer than 2n digits are divided the usual way.
+    big_uint reduce(const big_uint & x) const;
+    // a b mod m and a^2 mod m, where a, b < m.
+    big_uint mul_mod(const big_uint & a, const big_uint & b) const;
+    big_uint sqr_mod(const big_uint & a) const;
+};
+
+}
@@ -7,6 +7,11 @@
 
 namespace big {
 
+struct to_chars_result;
+struct from_chars_result;
+class binary_writer;
+class binary_reader;
+
 class big_int {
 public:
     enum class sign_t {
@@ -26,6 +31,7 @@ public:
     big_int() = default;
     big_int(sdigit x);
     big_int(const std::string & number);
+    explicit big_int(big_uint m);
     big_int(const big_int &) = default;
     big_int(big_int &&) = default;
     big_int & operator=(const big_int &) = default;
@@ -93,10 +99,30 @@ public:
 
     bool satisfies_invariant() const;
 
+    big_int square() const;
     big_int pow(digit e) const;
 
     friend std::ostream & operator<<(std::ostream & os, const big_int & x);
     friend std::istream & operator>>(std::istream & os, big_int & x);
+
+    // Declared with their default arguments in charconv.hpp.
+    friend to_chars_result to_chars(char * first, char * last, const big_int & x,
+                                    int base);
+    friend std::size_t to_chars_size(const big_int & x, int base);
+    friend from_chars_result from_chars(const char * first, const char * last,
+                                        big_int & x, int base);
+
+    // Declared with their default arguments in chunked_writer.hpp.
+    friend void write_chunked(std::ostream & os, const big_int & x, int base,
+                              std::size_t chunk_size);
+    friend void write_chunked(int fd, const big_int & x, int base, std::size_t chunk_size);
+
+    // Nonnegative as those of big_uint.
+    friend big_int gcd(const big_int & x, const big_int & y);
+    friend big_int lcm(const big_int & x, const big_int & y);
+
+    friend class binary_writer;
+    friend class binary_reader;
 };
 
 }
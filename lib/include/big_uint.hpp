@@ -6,34 +6,21 @@
 #include <type_traits>
 #include <deque>
 
-namespace big {
+#include "digit.hpp"
+#include "digit_vector.hpp"
+#include "digit_view.hpp"
 
-using digit      = unsigned int;
-using long_digit = unsigned long;
-using sdigit     = int;
-
-static_assert(sizeof(long_digit) == 2 * sizeof(digit), 
-              "long_digit must be twice as long as digit");
-static_assert(std::is_unsigned<digit>::value,
-              "digit must be unsigned");
-static_assert(std::is_unsigned<long_digit>::value,
-              "long_digit must be unsigned");
-static_assert(sizeof(sdigit) == sizeof(digit), 
-              "sdigit must be as long as digit");
-static_assert(std::is_signed<sdigit>::value,
-              "sdigit must be signed");
+namespace big {
 
 /*
  * The class contains positive integer value of arbitrary length. The value is
- * contained as a sequence of digits in base-2^32 system.
+ * contained as a sequence of digits in base-2^BIG_DIGIT_BITS system.
  * It doesn't overflow in multiplication and addition. 
  * Substraction greater from smaller number is undefined behaviour. For well
  * definded behaviour use big_int.
  */
 class big_uint {
-    static size_t karatsuba_threshold;
-
-    std::deque<digit> _digits;
+    digit_vector _digits;
 
     void add_with_shift(const big_uint & x, size_t s);
 
@@ -42,6 +29,8 @@ public:
     explicit big_uint(digit d);
     big_uint(std::initializer_list<digit> digits);
     big_uint(std::deque<digit> d);
+    // Adopts the buffer of d without copying the digits.
+    big_uint(digit_vector d);
     big_uint(const std::string & num);
     big_uint(const big_uint &) = default;
     big_uint(big_uint &&) = default;
@@ -49,11 +38,28 @@ public:
     big_uint & operator=(big_uint &&) = default;
     big_uint & operator=(digit d);
 
-    const std::deque<digit> digits() const;
-
-    static void set_karatsuba_threshold(size_t threshold) {
-        karatsuba_threshold = threshold;
-    }
+    digit_view digits() const { return _digits; }
+
+    // Moves the digits out leaving zero behind.
+    digit_vector release_digits();
+
+    // Operands longer than the threshold are multiplied by Karatsuba.
+    static void set_karatsuba_threshold(size_t threshold);
+    // Operands longer than the thresholds are multiplied by Toom-3 and Toom-4.
+    static void set_toom3_threshold(size_t threshold);
+    static void set_toom4_threshold(size_t threshold);
+    // Longer operands are multiplied by number-theoretic transforms.
+    static void set_ntt_threshold(size_t threshold);
+    // Longer operands are squared by Karatsuba rather than schoolbook.
+    static void set_karatsuba_square_threshold(size_t threshold);
+    // Divisors and quotients longer than the threshold are divided by the
+    // recursive algorithm of Burnikel and Ziegler.
+    static void set_burnikel_ziegler_threshold(size_t threshold);
+    // Divisors longer than the threshold are inverted by Newton iteration
+    // when the quotient is at least as long. See also reciprocal.
+    static void set_newton_threshold(size_t threshold);
+    // Longer numbers are converted to and from text by divide and conquer.
+    static void set_radix_threshold(size_t threshold);
 
     big_uint & operator++();
     big_uint & operator--();
@@ -83,6 +89,9 @@ public:
 
     static big_uint school_multiply(const big_uint & lhs, const big_uint & rhs);
     static big_uint karatsuba_multiply(const big_uint & lhs, const big_uint & rhs);
+    static big_uint toom3_multiply(const big_uint & lhs, const big_uint & rhs);
+    static big_uint toom4_multiply(const big_uint & lhs, const big_uint & rhs);
+    static big_uint ntt_multiply(const big_uint & lhs, const big_uint & rhs);
 
 #define COMMUTATIVE(sign) \
     return std::move(rhs sign##= lhs);
@@ -170,30 +179,24 @@ public:
     friend bool operator==(const big_uint & lhs, long_digit rhs);
     friend bool operator!=(const big_uint & lhs, long_digit rhs);
 
-    friend bool operator<(digit lhs, const big_uint & rhs);
-    friend bool operator>(digit lhs, const big_uint & rhs);
-    friend bool operator<=(digit lhs, const big_uint & rhs);
-    friend bool operator>=(digit lhs, const big_uint & rhs);
-    friend bool operator==(digit lhs, const big_uint & rhs);
-    friend bool operator!=(digit lhs, const big_uint & rhs);
-    friend bool operator<(const big_uint & lhs, digit rhs);
-    friend bool operator>(const big_uint & lhs, digit rhs);
-    friend bool operator<=(const big_uint & lhs, digit rhs);
-    friend bool operator>=(const big_uint & lhs, digit rhs);
-    friend bool operator==(const big_uint & lhs, digit rhs);
-    friend bool operator!=(const big_uint & lhs, digit rhs);
-
+    // The same as *this * *this, but the symmetry saves up to half the work.
+    big_uint square() const;
     big_uint pow(digit e) const;
-    //big_uint pow_mod(long e, big_uint mod) const;
+    // *this^e mod m, m > 0. Odd moduli are handled by Montgomery multiplication.
+    big_uint pow_mod(const big_uint & e, const big_uint & m) const;
 
     bool satisfies_invariant() const;
 
-    friend std::ostream & operator<<(std::ostream & os, big_uint x);
+    friend std::ostream & operator<<(std::ostream & os, const big_uint & x);
     friend std::istream & operator>>(std::istream & is, big_uint & x);
 
     friend void swap(big_uint & lhs, big_uint & rhs) {
-        std::swap(lhs._digits, rhs._digits);
+        lhs._digits.swap(rhs._digits);
     }
 };
 
+// Greatest common divisor and least common multiple, gcd(0, 0) = lcm(x, 0) = 0.
+big_uint gcd(const big_uint & x, const big_uint & y);
+big_uint lcm(const big_uint & x, const big_uint & y);
+
 }
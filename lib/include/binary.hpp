@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "big_int.hpp"
+#include "big_uint.hpp"
+
+/*
+ * Binary format of a sequence of numbers. A stream starts with the 8 byte
+ * header
+ *
+ *     'b' 'i' 'g' 'n' version limb_bytes 0 0
+ *
+ * followed by the numbers. A number is a varint (LEB128) of 2 n + negative
+ * and n little-endian limbs of limb_bytes bytes, the top one not zero. Zero
+ * has no limbs. The limbs start at a multiple of limb_bytes from the
+ * beginning of the stream, the gap is filled with zeros, so a reader of an
+ * aligned buffer can use them where they are.
+ */
+namespace big {
+
+// Version written by binary_writer. Readers accept it and all older ones.
+const unsigned binary_version = 1;
+
+/*
+ * Writes the header on construction and the numbers one by one. Errors are
+ * reported by the state of the stream.
+ */
+class binary_writer {
+    std::ostream & _os;
+    std::size_t    _offset;
+
+    void write(bool negative, digit_view digits);
+
+public:
+    explicit binary_writer(std::ostream & os);
+
+    binary_writer & write(const big_uint & x);
+    binary_writer & write(const big_int & x);
+};
+
+/*
+ * File mapped read only into memory. Numbers read from it borrow their limbs
+ * from the mapping, so the object must outlive them. Such a number copies
+ * its limbs before it's first modified, which leaves the mapping and any
+ * other number read from the same bytes as they were.
+ */
+class mapped_file {
+    char *      _data;
+    std::size_t _size;
+
+public:
+    // Throws std::system_error if the file can't be opened or mapped.
+    explicit mapped_file(const std::string & path);
+    mapped_file(const mapped_file &) = delete;
+    mapped_file & operator=(const mapped_file &) = delete;
+    ~mapped_file();
+
+    const char * data() const { return _data; }
+    std::size_t size() const { return _size; }
+};
+
+/*
+ * Reads numbers written by binary_writer from memory. There is no parsing,
+ * the limbs are copied as they are, or not at all when reading a
+ * mapped_file written with the digit width of the library on a
+ * little-endian machine. Malformed data throws std::runtime_error.
+ */
+class binary_reader {
+    const char *        _first;
+    const char *        _pos;
+    const char *        _last;
+    unsigned            _limb_bytes;
+    const mapped_file * _file;
+
+    const char * next(bool & negative, std::size_t & n);
+    big_uint take(const char * limbs, std::size_t n) const;
+
+public:
+    // [first, last) is a whole stream. It's only read during the calls.
+    binary_reader(const char * first, const char * last);
+    explicit binary_reader(const mapped_file & file);
+
+    bool at_end() const { return _pos == _last; }
+
+    // Returns false at the end of the data. Negative numbers throw for big_uint.
+    bool read(big_uint & x);
+    bool read(big_int & x);
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#include "big_int.hpp"
+#include "big_uint.hpp"
+
+/*
+ * Conversion to and from text in the manner of std::to_chars and
+ * std::from_chars: no locale, no stream state, no leading whitespace, no
+ * base prefix. Bases are 2 to 36, digits above 9 are letters, written in
+ * lower case and read in either case. Bases 2, 4, 8, 16 and 32 take linear
+ * time, the others that of division.
+ */
+namespace big {
+
+struct to_chars_result {
+    char *    ptr;
+    std::errc ec;
+};
+
+struct from_chars_result {
+    const char * ptr;
+    std::errc    ec;
+};
+
+/*
+ * Writes x to the beginning of [first, last). On success ptr is one past the
+ * last character written. If x doesn't fit, ptr is last, ec is
+ * std::errc::value_too_large and the contents of the range are unspecified.
+ */
+to_chars_result to_chars(char * first, char * last, const big_uint & x, int base = 10);
+to_chars_result to_chars(char * first, char * last, const big_int & x, int base = 10);
+
+// Exact number of characters to_chars writes for x.
+std::size_t to_chars_size(const big_uint & x, int base = 10);
+std::size_t to_chars_size(const big_int & x, int base = 10);
+
+// x written by to_chars.
+std::string to_string(const big_uint & x, int base = 10);
+std::string to_string(const big_int & x, int base = 10);
+
+/*
+ * Reads the longest run of digits of the base at the beginning of
+ * [first, last), preceded by '-' for big_int. On success ptr is one past the
+ * run. If there are no digits, ptr is first, ec is
+ * std::errc::invalid_argument and x is unchanged.
+ */
+from_chars_result from_chars(const char * first, const char * last, big_uint & x,
+                             int base = 10);
+from_chars_result from_chars(const char * first, const char * last, big_int & x,
+                             int base = 10);
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+
+#include "big_int.hpp"
+#include "big_uint.hpp"
+
+/*
+ * Output of numbers too long to format into memory. The text is produced
+ * most significant character first and passed on in pieces of at most
+ * chunk_size characters, so besides one chunk only O(n) digits are held.
+ * Bases are 2 to 36 as in to_chars.
+ */
+namespace big {
+
+const std::size_t default_chunk_size = 1 << 16;
+
+// Errors are reported by the state of the stream.
+void write_chunked(std::ostream & os, const big_uint & x, int base = 10,
+                   std::size_t chunk_size = default_chunk_size);
+void write_chunked(std::ostream & os, const big_int & x, int base = 10,
+                   std::size_t chunk_size = default_chunk_size);
+
+// Throws std::system_error if writing to the file descriptor fails.
+void write_chunked(int fd, const big_uint & x, int base = 10,
+                   std::size_t chunk_size = default_chunk_size);
+void write_chunked(int fd, const big_int & x, int base = 10,
+                   std::size_t chunk_size = default_chunk_size);
+
+}
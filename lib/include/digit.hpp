@@ -0,0 +1,45 @@
+#pragma once
+
+#include <type_traits>
+
+/*
+ * Width of a single digit in bits. Either 32 (default) or 64. The 64-bit mode
+ * needs unsigned __int128 and halves the number of digits on 64-bit machines.
+ * Every translation unit using the library must be built with the same value.
+ */
+#ifndef BIG_DIGIT_BITS
+#define BIG_DIGIT_BITS 32
+#endif
+
+namespace big {
+
+#if BIG_DIGIT_BITS == 32
+using digit      = unsigned int;
+using long_digit = unsigned long;
+using sdigit     = int;
+#elif BIG_DIGIT_BITS == 64
+#ifndef __SIZEOF_INT128__
+#error "64-bit digits require unsigned __int128"
+#endif
+using digit      = unsigned long long;
+__extension__ typedef unsigned __int128 long_digit;
+using sdigit     = long long;
+#else
+#error "BIG_DIGIT_BITS must be 32 or 64"
+#endif
+
+static_assert(8 * sizeof(digit) == BIG_DIGIT_BITS,
+              "digit must be BIG_DIGIT_BITS long");
+static_assert(sizeof(long_digit) == 2 * sizeof(digit), 
+              "long_digit must be twice as long as digit");
+static_assert(std::is_unsigned<digit>::value,
+              "digit must be unsigned");
+// std::is_unsigned is false for unsigned __int128 in strict ISO mode.
+static_assert(long_digit(0) < long_digit(-1),
+              "long_digit must be unsigned");
+static_assert(sizeof(sdigit) == sizeof(digit), 
+              "sdigit must be as long as digit");
+static_assert(std::is_signed<sdigit>::value,
+              "sdigit must be signed");
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+
+#include "digit.hpp"
+
+namespace big {
+
+/*
+ * Source of digit buffers for digit_vector and therefore for big_uint and
+ * big_int. Every buffer is returned to the allocator it came from.
+ */
+class digit_allocator {
+public:
+    virtual ~digit_allocator() = default;
+
+    // Capacity which will actually be used for a request of n digits.
+    virtual std::size_t round_up(std::size_t n) const { return n; }
+
+    virtual digit * allocate(std::size_t n) = 0;
+    virtual void deallocate(digit * p, std::size_t n) = 0;
+};
+
+// Plain operator new / operator delete. Compatible with std::allocator<digit>.
+digit_allocator & heap_allocator();
+
+/*
+ * Pool which recycles buffers by power-of-two size class. Free buffers are
+ * cached per thread so neither allocation nor deallocation synchronizes. A
+ * buffer may be released on any thread.
+ */
+digit_allocator & pool_allocator();
+
+// Upper bound of memory cached by pool_allocator per size class per thread.
+void set_pool_cache_limit(std::size_t bytes);
+
+/*
+ * Allocator used by new numbers on the calling thread. Defaults to
+ * pool_allocator().
+ */
+digit_allocator & default_allocator();
+void set_default_allocator(digit_allocator & alloc);
+
+/*
+ * Makes alloc the default allocator of the calling thread for the lifetime of
+ * the object.
+ */
+class allocator_scope {
+    digit_allocator & _previous;
+
+public:
+    explicit allocator_scope(digit_allocator & alloc)
+        : _previous(default_allocator()) {
+        set_default_allocator(alloc);
+    }
+    allocator_scope(const allocator_scope &) = delete;
+    allocator_scope & operator=(const allocator_scope &) = delete;
+    ~allocator_scope() { set_default_allocator(_previous); }
+};
+
+}
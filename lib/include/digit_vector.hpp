@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "digit.hpp"
+#include "digit_allocator.hpp"
+
+namespace big {
+
+/*
+ * Contiguous sequence of digits. A few digits are stored inline in the object
+ * itself so small values never touch the allocator. Larger sequences live in a
+ * buffer which grows geometrically. The buffer comes from the allocator given
+ * at construction or from the default allocator of the thread which first
+ * needed it. A vector may also borrow digits it doesn't own, which it copies
+ * into a buffer of its own on detach() or when its size changes.
+ */
+class digit_vector {
+public:
+    using value_type             = digit;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = digit &;
+    using const_reference        = const digit &;
+    using pointer                = digit *;
+    using const_pointer          = const digit *;
+    using iterator               = digit *;
+    using const_iterator         = const digit *;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type inline_capacity = 4;
+
+private:
+    digit *           _data;
+    size_type         _size;
+    size_type         _capacity;
+    digit_allocator * _alloc;
+    digit             _inline[inline_capacity];
+
+    bool is_inline() const { return _data == _inline; }
+    // Only borrowed digits have no capacity, adopted buffers have some.
+    bool is_borrowed() const { return !_capacity; }
+
+    void reallocate(size_type capacity);
+    void release();
+
+public:
+    digit_vector() 
+        : _data(_inline)
+        , _size(0)
+        , _capacity(inline_capacity)
+        , _alloc(nullptr) { }
+    explicit digit_vector(digit_allocator & alloc) : digit_vector() {
+        _alloc = &alloc;
+    }
+    explicit digit_vector(size_type n, digit value = 0);
+    digit_vector(std::initializer_list<digit> digits);
+    digit_vector(const digit_vector & x);
+    digit_vector(digit_vector && x) noexcept;
+    ~digit_vector() { release(); }
+
+    template <typename It,
+              typename = std::enable_if_t<!std::is_integral<It>::value>>
+    digit_vector(It first, It last) : digit_vector() {
+        reserve(std::distance(first, last));
+        for (; first != last; ++first) _data[_size++] = *first;
+    }
+
+    digit_vector & operator=(const digit_vector & x);
+    digit_vector & operator=(digit_vector && x) noexcept;
+
+    /*
+     * Takes ownership of a buffer of capacity > 0 digits, first size of
+     * which are in use. The buffer must be allocated with alloc. The heap
+     * allocator is compatible with std::allocator<digit>.
+     */
+    static digit_vector adopt(digit * data, size_type size, size_type capacity,
+                              digit_allocator & alloc = heap_allocator());
+
+    /*
+     * Refers to size digits owned elsewhere, which must stay unchanged while
+     * the vector reads them and may be read only memory. They must not be
+     * written through the vector before detach().
+     */
+    static digit_vector borrow(const digit * data, size_type size);
+
+    // Copies borrowed digits into a buffer of the vector's own.
+    void detach() {
+        if (is_borrowed()) reallocate(std::max<size_type>(_size, 1));
+    }
+
+    digit_allocator & get_allocator() const {
+        return _alloc ? *_alloc : default_allocator();
+    }
+
+    size_type size() const { return _size; }
+    size_type capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    digit * data() { return _data; }
+    const digit * data() const { return _data; }
+
+    digit & operator[](size_type i) { return _data[i]; }
+    const digit & operator[](size_type i) const { return _data[i]; }
+
+    digit & front() { return _data[0]; }
+    const digit & front() const { return _data[0]; }
+    digit & back() { return _data[_size - 1]; }
+    const digit & back() const { return _data[_size - 1]; }
+
+    iterator begin() { return _data; }
+    iterator end() { return _data + _size; }
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    void reserve(size_type n) {
+        if (n > _capacity) reallocate(std::max(n, 2 * _capacity));
+    }
+
+    void push_back(digit d) {
+        if (_size >= _capacity) reallocate(std::max(2 * _capacity, _size + 1));
+        _data[_size++] = d;
+    }
+
+    void pop_back() { --_size; }
+
+    void resize(size_type n, digit value = 0) {
+        reserve(n);
+        if (n > _size) std::fill(_data + _size, _data + n, value);
+        _size = n;
+    }
+
+    void clear() { _size = 0; }
+
+    void swap(digit_vector & x) noexcept;
+
+    friend void swap(digit_vector & lhs, digit_vector & rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    friend bool operator==(const digit_vector & lhs, const digit_vector & rhs) {
+        return lhs._size == rhs._size &&
+            std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(const digit_vector & lhs, const digit_vector & rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+}
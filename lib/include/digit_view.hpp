@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+#include "digit.hpp"
+#include "digit_vector.hpp"
+
+namespace big {
+
+/*
+ * Non-owning read-only view over a contiguous sequence of digits, least
+ * significant digit first. The view is invalidated by any operation that
+ * modifies the viewed number.
+ */
+class digit_view {
+public:
+    using value_type             = digit;
+    using size_type              = std::size_t;
+    using const_reference        = const digit &;
+    using const_pointer          = const digit *;
+    using const_iterator         = const digit *;
+    using iterator               = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator       = const_reverse_iterator;
+
+private:
+    const digit * _data;
+    size_type     _size;
+
+public:
+    digit_view() : _data(nullptr), _size(0) { }
+    digit_view(const digit * data, size_type size) : _data(data), _size(size) { }
+    digit_view(const digit_vector & digits)
+        : _data(digits.data())
+        , _size(digits.size()) { }
+
+    size_type size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    const digit * data() const { return _data; }
+
+    const digit & operator[](size_type i) const { return _data[i]; }
+    const digit & front() const { return _data[0]; }
+    const digit & back() const { return _data[_size - 1]; }
+
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    friend bool operator==(digit_view lhs, digit_view rhs) {
+        return lhs._size == rhs._size &&
+            std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(digit_view lhs, digit_view rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+}
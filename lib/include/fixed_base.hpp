@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "big_uint.hpp"
+
+namespace big {
+
+const std::size_t default_table_bytes = 1 << 20;
+
+/*
+ * g^e mod m for a fixed g and m and many exponents e. Powers of g are
+ * precomputed once into a comb table after C. H. Lim and P. J. Lee, after
+ * which an exponent of l bits takes roughly l / h multiplications and
+ * l / (h v) squarings for v tables of 2^h - 1 residues, against about l
+ * squarings and l / 6 multiplications of pow_mod. h and v are chosen for
+ * the least work within the table memory given. Copies share the table.
+ */
+class fixed_base {
+public:
+    class table;
+
+private:
+    std::shared_ptr<const table> _table;
+
+public:
+    // m > 0. Exponents longer than exponent_bits are still accepted but are
+    // raised without the table.
+    fixed_base(const big_uint & g, const big_uint & m, std::size_t exponent_bits,
+               std::size_t table_bytes = default_table_bytes);
+
+    // g mod m.
+    const big_uint & base() const;
+    const big_uint & modulus() const;
+    std::size_t exponent_bits() const;
+    // Number of residues in the table.
+    std::size_t table_size() const;
+
+    big_uint pow(const big_uint & e) const;
+};
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+
+#include "big_uint.hpp"
+#include "digit_vector.hpp"
+
+namespace big {
+
+namespace detail {
+class montgomery;
+}
+
+/*
+ * Residue modulo an odd m > 1 kept in Montgomery form, so a chain of
+ * operations converts only at its ends and every product is a
+ * multiplication plus a reduction without division. The modulus with its
+ * constants (R^2 mod m and -m^-1 mod B) lives in a context shared by
+ * reference count among all values created from it. Operands of binary
+ * operations must come from the same context.
+ */
+class mod_int {
+public:
+    class context {
+        std::shared_ptr<const detail::montgomery> _impl;
+
+        friend class mod_int;
+
+    public:
+        explicit context(const big_uint & m);
+
+        const big_uint & modulus() const;
+    };
+
+private:
+    context      _context;
+    digit_vector _value;
+
+    explicit mod_int(const context & c);
+
+    const detail::montgomery & impl() const { return *_context._impl; }
+
+public:
+    // x mod m.
+    mod_int(const context & c, const big_uint & x);
+
+    const context & get_context() const { return _context; }
+    const big_uint & modulus() const { return _context.modulus(); }
+
+    // The residue as a number less than m.
+    big_uint value() const;
+
+    mod_int & operator+=(const mod_int & x);
+    mod_int & operator-=(const mod_int & x);
+    mod_int & operator*=(const mod_int & x);
+
+    friend mod_int operator+(mod_int lhs, const mod_int & rhs) { return lhs += rhs; }
+    friend mod_int operator-(mod_int lhs, const mod_int & rhs) { return lhs -= rhs; }
+    friend mod_int operator*(mod_int lhs, const mod_int & rhs) { return lhs *= rhs; }
+
+    mod_int operator-() const;
+    mod_int square() const;
+    mod_int pow(const big_uint & e) const;
+    // Throws std::domain_error if the residue isn't coprime to m.
+    mod_int inverse() const;
+
+    friend bool operator==(const mod_int & lhs, const mod_int & rhs) {
+        return lhs._value == rhs._value;
+    }
+
+    friend bool operator!=(const mod_int & lhs, const mod_int & rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+}
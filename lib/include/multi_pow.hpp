@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "big_uint.hpp"
+
+namespace big {
+
+/*
+ * The product of g[i]^e[i] mod m over i < k, in one pass with the squarings
+ * shared rather than as k exponentiations. Few bases use interleaved
+ * sliding windows (Straus, of which Shamir's trick is the one bit case),
+ * many use Pippenger's buckets, which make each base cost about one
+ * multiplication per window of log k bits. m > 0.
+ */
+big_uint multi_pow(const big_uint * g, const big_uint * e, std::size_t k, const big_uint & m);
+
+// g and e of the same size.
+big_uint multi_pow(const std::vector<big_uint> & g, const std::vector<big_uint> & e,
+                   const big_uint & m);
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "big_uint.hpp"
+#include "digit_vector.hpp"
+
+namespace big {
+
+/*
+ * Precomputed inverse of a divisor for dividing many numbers by it. The
+ * inverse is found by Newton iteration once, then every division costs
+ * about two multiplications per divisor length of the quotient.
+ */
+class reciprocal {
+    big_uint     _divisor;
+    // The divisor shifted left so that its top bit is set.
+    digit_vector _normalized;
+    // floor(B^2n / _normalized), n + 1 digits.
+    digit_vector _inverse;
+    unsigned     _shift;
+
+public:
+    explicit reciprocal(const big_uint & divisor);
+
+    const big_uint & divisor() const { return _divisor; }
+
+    big_uint div(const big_uint & dividend, big_uint & reminder) const;
+    big_uint div(const big_uint & dividend) const;
+    big_uint mod(const big_uint & dividend) const;
+};
+
+}
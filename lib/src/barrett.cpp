@@ -0,0 +1,112 @@
+#include "barrett.hpp"
+#include "digit_ops.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace big {
+
+using namespace std;
+
+barrett_context::barrett_context(const big_uint & m) : _modulus(m) {
+    assert(m != 0u);
+    size_t n = m.digits().size();
+    digit_vector power(2 * n + 1);
+    power[2 * n] = 1;
+    _mu = (big_uint(move(power)) / m).release_digits();
+}
+
+namespace {
+
+/*
+ * Moduli up to this length use schoolbook partial products, longer ones
+ * full subquadratic products. Measured on x86-64.
+ */
+const size_t short_product_limit = detail::digit_bits == 32 ? 96 : 48;
+
+/*
+ * Columns k and up of a b into r of an + bn digits, without the carries out
+ * of the lower columns. Those are less than an B^(k + 1).
+ */
+void multiply_high(digit * r, const digit * a, size_t an, const digit * b, size_t bn,
+                   size_t k) {
+    fill(r, r + an + bn, 0);
+    for (size_t i = 0; i < an; ++i) {
+        size_t j = k > i ? k - i : 0;
+        if (j < bn) r[i + bn] = detail::addmul_1(r + i + j, b + j, bn - j, a[i]);
+    }
+}
+
+// r = a b mod B^rn.
+void multiply_low(digit * r, size_t rn, const digit * a, size_t an, const digit * b,
+                  size_t bn) {
+    fill(r, r + rn, 0);
+    for (size_t i = 0; i < an && i < rn; ++i) {
+        size_t len = min(bn, rn - i);
+        digit carry = detail::addmul_1(r + i, b, len, a[i]);
+        if (i + len < rn) r[i + len] = carry;
+    }
+}
+
+}
+
+/*
+ * With q1 = floor(x / B^(n-1)) the estimate q3 = floor(q1 mu / B^(n+1))
+ * is at most 2 below floor(x / m). Short moduli leave out the columns of
+ * q1 mu below n - 2, which costs at most one more, and of q3 m only the
+ * low n + 1 digits are formed. Then r = x - q3 m < 4m fits into n + 1
+ * digits and is computed modulo B^(n+1).
+ */
+big_uint barrett_context::reduce(const big_uint & x) const {
+    if (x < _modulus) return x;
+    digit_view a = x.digits();
+    digit_view d = _modulus.digits();
+    size_t n = d.size();
+    if (a.size() > 2 * n) return x % _modulus;
+    size_t qn = a.size() - (n - 1);
+    size_t mn = _mu.size();
+    bool school = n <= short_product_limit;
+    digit_vector q(qn + mn);
+    digit_vector scratch;
+    if (school) {
+        multiply_high(q.data(), a.data() + n - 1, qn, _mu.data(), mn, n > 2 ? n - 2 : 0);
+    } else {
+        scratch.resize(max(detail::multiply_scratch_size(qn, mn),
+                           detail::multiply_scratch_size(qn + mn - (n + 1), n)));
+        detail::multiply(q.data(), a.data() + n - 1, qn, _mu.data(), mn, scratch.data());
+    }
+    // mu has at least n + 1 digits, so q3 has at least one.
+    const digit * q3 = q.data() + n + 1;
+    size_t q3n = detail::normalized_size(q3, qn + mn - (n + 1));
+
+    digit_vector r(n + 1);
+    copy(a.begin(), a.begin() + min(a.size(), n + 1), r.begin());
+    if (q3n) {
+        digit_vector p(max(q3n + n, n + 1));
+        if (school) {
+            multiply_low(p.data(), n + 1, q3, q3n, d.data(), n);
+        } else {
+            detail::multiply(p.data(), q3, q3n, d.data(), n, scratch.data());
+        }
+        detail::sub_n(r.data(), r.data(), p.data(), n + 1);
+    }
+    size_t rn = detail::normalized_size(r.data(), n + 1);
+    while (detail::compare(r.data(), rn, d.data(), n) >= 0) {
+        detail::sub(r.data(), r.data(), rn, d.data(), n);
+        rn = detail::normalized_size(r.data(), rn);
+    }
+    return big_uint(move(r));
+}
+
+big_uint barrett_context::mul_mod(const big_uint & a, const big_uint & b) const {
+    assert(a < _modulus && b < _modulus);
+    return reduce(a * b);
+}
+
+big_uint barrett_context::sqr_mod(const big_uint & a) const {
+    assert(a < _modulus);
+    return reduce(a.square());
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "barrett.hpp"
+#include "big_uint.hpp"
+
+namespace big {
+namespace detail {
+
+// Plain residues reduced by a Barrett context as the ring of exponent.hpp.
+class barrett_ring {
+    const barrett_context & _context;
+
+public:
+    using value = big_uint;
+
+    explicit barrett_ring(const barrett_context & context) : _context(context) { }
+
+    value one() const { return big_uint(1) % _context.modulus(); }
+
+    void multiply(value & r, const value & a, const value & b) {
+        r = _context.mul_mod(a, b);
+    }
+
+    void square(value & r, const value & a) {
+        r = _context.sqr_mod(a);
+    }
+};
+
+}
+}
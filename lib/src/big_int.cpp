@@ -1,6 +1,6 @@
 #include "big_int.hpp"
+#include "radix.hpp"
 #include <cmath>
-#include <sstream>
 #include <tuple>
 
 namespace big {
@@ -19,6 +19,8 @@ big_int::big_int(sign_t s, big_uint && m)
     fix_zero();
 }
 
+big_int::big_int(big_uint m) : big_int(sign_t::PLUS, move(m)) { }
+
 big_int & big_int::fix_zero() {
     if (_modulus == 0u)
         _sign = sign_t::PLUS;
@@ -29,19 +31,16 @@ big_int::big_int(sdigit x)
         : _sign(x < 0 ? sign_t::MINUS : sign_t::PLUS)
         , _modulus(abs(x)) { }
 
-// FIXME: This code has many memory allocation. First when _modulus is default
-// constructed. Second when isstream is constructed. Third when we read modulus
-// from string. The number of acllocations can be reduced to one.
 big_int::big_int(const std::string & number)
         : _sign(sign_t::PLUS) {
-    istringstream iss(number);
-    char c = iss.peek();
-    if (c == '+') { iss.ignore(); }
-    else if (c == '-') {
-        _sign = sign_t::MINUS;
-        iss.ignore();
+    const char * first = number.data();
+    const char * last = first + number.size();
+    if (first != last && (*first == '+' || *first == '-')) {
+        if (*first == '-') _sign = sign_t::MINUS;
+        ++first;
     }
-    iss >> _modulus;
+    _modulus = detail::read_radix(first, detail::scan_radix(first, last, 10), 10);
+    fix_zero();
 }
 
 big_int::sign_t big_int::sign() const {
@@ -379,6 +378,10 @@ bool big_int::satisfies_invariant() const {
         (_modulus != 0u || _sign == sign_t::PLUS);
 }
 
+big_int big_int::square() const {
+    return { sign_t::PLUS, _modulus.square() };
+}
+
 big_int big_int::pow(digit e) const {
     return { (0 == e % 2) ? sign_t::PLUS : _sign, _modulus.pow(e) };
 }
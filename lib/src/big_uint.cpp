@@ -1,18 +1,50 @@
 #include "big_uint.hpp"
+#include "radix.hpp"
+#include "digit_ops.hpp"
 
 #include <iterator>
 #include <algorithm>
-#include <sstream>
 #include <utility>
 #include <cassert>
+#include <limits>
+#include <vector>
 
 namespace big {
 
-// Precisely calculated value. 
-size_t big_uint::karatsuba_threshold = 100;
-
 using namespace std;
 
+void big_uint::set_karatsuba_threshold(size_t threshold) {
+    detail::karatsuba_threshold = threshold;
+}
+
+void big_uint::set_toom3_threshold(size_t threshold) {
+    detail::toom3_threshold = threshold;
+}
+
+void big_uint::set_toom4_threshold(size_t threshold) {
+    detail::toom4_threshold = threshold;
+}
+
+void big_uint::set_ntt_threshold(size_t threshold) {
+    detail::ntt_threshold = threshold;
+}
+
+void big_uint::set_karatsuba_square_threshold(size_t threshold) {
+    detail::karatsuba_square_threshold = threshold;
+}
+
+void big_uint::set_burnikel_ziegler_threshold(size_t threshold) {
+    detail::burnikel_ziegler_threshold = threshold;
+}
+
+void big_uint::set_newton_threshold(size_t threshold) {
+    detail::newton_threshold = threshold;
+}
+
+void big_uint::set_radix_threshold(size_t threshold) {
+    detail::radix_threshold = threshold;
+}
+
 big_uint::big_uint() : _digits(1, 0) { }
 
 big_uint::big_uint(digit d) : _digits(1, d) { }
@@ -21,7 +53,10 @@ big_uint::big_uint(initializer_list<digit> digits) : _digits(digits) {
     assert(satisfies_invariant());
 }
 
-big_uint::big_uint(deque<digit> digits) : _digits(digits) { 
+big_uint::big_uint(deque<digit> digits) 
+        : big_uint(digit_vector(digits.begin(), digits.end())) { }
+
+big_uint::big_uint(digit_vector digits) : _digits(move(digits)) { 
     while (!_digits.empty() && !_digits.back()) {
         _digits.pop_back();
     }
@@ -29,8 +64,8 @@ big_uint::big_uint(deque<digit> digits) : _digits(digits) {
 }
 
 big_uint::big_uint(const std::string & num) {
-    istringstream iss(num);
-    iss >> *this;
+    const char * first = num.data();
+    *this = detail::read_radix(first, detail::scan_radix(first, first + num.size(), 10), 10);
 }
 
 big_uint & big_uint::operator=(digit d) {
@@ -40,7 +75,9 @@ big_uint & big_uint::operator=(digit d) {
 }
 
 void big_uint::add_with_shift(const big_uint & x, size_t s) {
+    _digits.detach();
     if (_digits.size() <= s) _digits.resize(s + 1);
+    _digits.reserve(max(_digits.size(), s + x._digits.size()));
     auto prev  = _digits.begin() + s;
     auto it    = prev + 1;
     auto end   = _digits.end();
@@ -80,11 +117,15 @@ void big_uint::add_with_shift(const big_uint & x, size_t s) {
     }
 }
 
-const std::deque<digit> big_uint::digits() const {
-    return _digits;
+digit_vector big_uint::release_digits() {
+    _digits.detach();
+    digit_vector result(1);
+    result.swap(_digits);
+    return result;
 }
 
 big_uint & big_uint::operator++() {
+    _digits.detach();
     auto it = _digits.begin();
     auto end = _digits.end();
     do { ++*it; } while (0 == *it && ++it != end);
@@ -94,6 +135,7 @@ big_uint & big_uint::operator++() {
 
 big_uint & big_uint::operator--() {
     assert(_digits.size() > 1 || _digits[0] != 0);
+    _digits.detach();
     if (*this == 1u) {
         _digits[0] = 0;
         return *this;
@@ -118,73 +160,19 @@ big_uint big_uint::operator--(int) {
 }
 
 big_uint operator+(const big_uint & lhs, digit rhs) {
-    if (rhs == 0u) 
-        return lhs;
-    deque<digit> res;
-    auto prev = lhs._digits.begin();
-    auto it   = prev + 1;
-    auto end  = lhs._digits.end();
-    res.push_back(*prev + rhs);
-    if (res.back() < rhs) {
-        if (it == end) {
-            res.push_back(1);
-            return big_uint(res);
-        } 
-        res.push_back(*it + 1);
-        prev = it; 
-        ++it;
-    }
-    while (*prev == numeric_limits<digit>::max() && it != end) {
-        res.push_back(*it + 1);
-        prev = it; 
-        ++it;
-    }
-    if (*prev == numeric_limits<digit>::max() && it == end) 
-        res.push_back(1);
-    else
-        copy(it, end, back_inserter(res));
-    return big_uint(res);
+    big_uint res = lhs;
+    return res += rhs;
 }
 
 big_uint operator-(const big_uint & lhs, digit rhs) {
     assert(lhs >= rhs);
-    deque<digit> res;
-    auto prev = lhs._digits.begin();
-    auto it   = prev + 1;
-    auto end  = lhs._digits.end();
-    res.push_back(*prev - rhs);
-    if (res.back() > *prev) {
-        res.push_back(*it - 1);
-        prev = it; 
-        ++it;
-    }
-    while (res.back() == numeric_limits<digit>::max() && it != end) {
-        res.push_back(*it - 1);
-        prev = it; 
-        ++it;
-    }
-    if (res.size() != 1 && res.back() == 0) 
-        res.pop_back();
-    return big_uint(res);
+    big_uint res = lhs;
+    return res -= rhs;
 }
 
 big_uint operator*(const big_uint & lhs, digit rhs) {
-    if (rhs == 0u || lhs == 0u) 
-        return { 0u };
-    deque<digit> res;
-    digit carry = 0;
-    long_digit ld;
-    auto it = lhs._digits.begin();
-    auto end = lhs._digits.end();
-    while (it != end) {
-        ld = (long_digit) rhs * *it + carry;
-        res.push_back(ld);
-        carry = ld >> (sizeof(digit) * 8);
-        ++it;
-    }
-    if (carry) 
-        res.push_back(carry);
-    return big_uint(res);
+    big_uint res = lhs;
+    return res *= rhs;
 }
 
 big_uint operator/(const big_uint & lhs, digit rhs) {
@@ -194,9 +182,8 @@ big_uint operator/(const big_uint & lhs, digit rhs) {
 
 big_uint operator%(const big_uint & lhs, digit rhs) {
     assert(rhs != 0);
-    digit rem;
-    big_uint::div(lhs, rhs, rem);
-    return { rem };
+    digit_view a = lhs.digits();
+    return big_uint(detail::mod_1(a.data(), a.size(), detail::divisor_1(rhs)));
 }
 
 big_uint operator+(digit lhs, const big_uint & rhs) {
@@ -226,6 +213,7 @@ big_uint operator%(digit lhs, const big_uint & rhs) {
 
 big_uint & big_uint::operator+=(digit d) {
     if (d == 0) return *this;
+    _digits.detach();
     if (*this == 0u) {
         _digits[0] = d;
         return *this;
@@ -255,6 +243,7 @@ big_uint & big_uint::operator+=(digit d) {
 
 big_uint & big_uint::operator-=(digit d) {
     assert(*this >= d);
+    _digits.detach();
     auto prev = _digits.begin();
     auto it   = prev + 1;
     auto end  = _digits.end();
@@ -272,6 +261,7 @@ big_uint & big_uint::operator-=(digit d) {
 
 big_uint & big_uint::operator*=(digit d) {
     if (*this == 0u) return *this;
+    _digits.detach();
     if (d == 0) {
         _digits.resize(1);
         _digits[0] = 0;
@@ -293,15 +283,17 @@ big_uint & big_uint::operator*=(digit d) {
 
 big_uint & big_uint::operator/=(digit d) {
     assert(d != 0);
-    return *this = div(*this, d);
+    _digits.detach();
+    detail::divrem_1(_digits.data(), _digits.data(), _digits.size(), d);
+    if (_digits.size() != 1 && _digits.back() == 0) _digits.pop_back();
+    return *this;
 }
 
 big_uint & big_uint::operator%=(digit d) {
     assert(d != 0);
-    digit rem;
-    div(*this, d, rem); 
-    _digits.clear();
-    _digits.push_back(rem);
+    digit rem = detail::mod_1(_digits.data(), _digits.size(), detail::divisor_1(d));
+    _digits.resize(1);
+    _digits[0] = rem;
     return *this;
 }
 
@@ -311,26 +303,10 @@ big_uint big_uint::div(const big_uint & dividend, digit divisor, digit & reminde
         reminder = dividend._digits[0];
         return { 0u };
     }
-    auto it  = dividend._digits.rbegin();
-    auto end = dividend._digits.rend();
-    deque<digit> quot;
-    long_digit x = *it;
-    ++it;
-    if (x < divisor) {
-        x <<= sizeof(digit) * 8;
-        x |= *it;
-        ++it;
-    }
-    while (true) {
-        quot.push_front(x / divisor);
-        x = x % divisor;
-        if (it == end) break;
-        x <<= sizeof(digit) * 8;
-        x |= *it;
-        ++it;
-    }
-    reminder = x;
-    return big_uint(quot);
+    digit_vector quot(dividend._digits.size());
+    reminder = detail::divrem_1(quot.data(), dividend._digits.data(),
+                                quot.size(), divisor);
+    return big_uint(move(quot));
 }
 
 big_uint big_uint::div(const big_uint & dividend, digit divisor) {
@@ -345,6 +321,7 @@ big_uint & big_uint::operator+=(const big_uint & x) {
 
 big_uint & big_uint::operator-=(const big_uint & x) { 
     assert(*this >= x);
+    _digits.detach();
     auto prev  = _digits.begin();
     auto it    = prev + 1;
     auto end   = _digits.end();
@@ -376,53 +353,68 @@ big_uint & big_uint::operator-=(const big_uint & x) {
     }
     if (it != end) return *this;
     ++msd;
-    _digits.erase(msd, end);
+    _digits.resize(msd - _digits.begin());
     return *this;
 }
 
 big_uint big_uint::school_multiply(const big_uint & lhs, const big_uint & rhs) {
-    if (lhs == 1u) return rhs;
-    if (lhs == 0u || rhs == 0u) return { 0u };
-    big_uint res;
-    for (size_t s = 0; s < lhs._digits.size(); ++s) {
-        res.add_with_shift(rhs * lhs._digits[s], s);
-    }
-    return res;
+    digit_view a = lhs.digits(), b = rhs.digits();
+    digit_vector product(a.size() + b.size());
+    detail::school_multiply(product.data(), a.data(), a.size(), b.data(), b.size());
+    return big_uint(move(product));
 }
 
-/*
- * (a + bx)(c + dx) = ac + ((a + b)(c + d) - ac - bd) * x + db * x^2
- */
 big_uint big_uint::karatsuba_multiply(const big_uint & lhs, const big_uint & rhs) {
     // This function is useful only for big numbers.
     assert(lhs._digits.size() > 1);
     assert(rhs._digits.size() > 1);
 
-    auto digit_size = max(lhs._digits.size(), rhs._digits.size()) / 2;
-    auto lhs_begin = lhs._digits.begin();
-    auto lhs_mid = lhs_begin + digit_size;
-    auto lhs_end = lhs._digits.end();
-    big_uint a{ deque<digit>(lhs_begin, lhs_mid) };
-    big_uint b{ deque<digit>(lhs_mid, lhs_end) };
-    auto rhs_begin = rhs._digits.begin();
-    auto rhs_mid = rhs_begin + digit_size;
-    auto rhs_end = rhs._digits.end();
-    big_uint c{ deque<digit>(rhs_begin, rhs_mid) };
-    big_uint d{ deque<digit>(rhs_mid, rhs_end) };
-    big_uint ac = a * c;
-    big_uint bd = b * d;
-    ac.add_with_shift((move(a) + b) * (move(c) + d) - ac - bd, digit_size);
-    ac.add_with_shift(bd, 2 * digit_size);
-    return ac;
+    digit_view a = lhs.digits(), b = rhs.digits();
+    digit_vector product(a.size() + b.size());
+    digit_vector scratch(detail::karatsuba_scratch_size(a.size(), b.size()));
+    detail::karatsuba_multiply(product.data(), a.data(), a.size(), 
+                               b.data(), b.size(), scratch.data());
+    return big_uint(move(product));
+}
+
+big_uint big_uint::toom3_multiply(const big_uint & lhs, const big_uint & rhs) {
+    digit_view a = lhs.digits(), b = rhs.digits();
+    digit_vector product(a.size() + b.size());
+    digit_vector scratch(detail::toom3_scratch_size(a.size(), b.size()));
+    detail::toom3_multiply(product.data(), a.data(), a.size(),
+                           b.data(), b.size(), scratch.data());
+    return big_uint(move(product));
+}
+
+big_uint big_uint::toom4_multiply(const big_uint & lhs, const big_uint & rhs) {
+    digit_view a = lhs.digits(), b = rhs.digits();
+    digit_vector product(a.size() + b.size());
+    digit_vector scratch(detail::toom4_scratch_size(a.size(), b.size()));
+    detail::toom4_multiply(product.data(), a.data(), a.size(),
+                           b.data(), b.size(), scratch.data());
+    return big_uint(move(product));
+}
+
+big_uint big_uint::ntt_multiply(const big_uint & lhs, const big_uint & rhs) {
+    digit_view a = lhs.digits(), b = rhs.digits();
+    // Products too long for the transform are split by Toom-4 first.
+    if (!detail::ntt_supports(a.size(), b.size())) return lhs * rhs;
+    digit_vector product(a.size() + b.size());
+    digit_vector scratch(detail::ntt_scratch_size(a.size(), b.size()));
+    detail::ntt_multiply(product.data(), a.data(), a.size(),
+                         b.data(), b.size(), scratch.data());
+    return big_uint(move(product));
 }
 
 big_uint & big_uint::operator*=(const big_uint & x) {
-    size_t min_size = min(_digits.size(), x._digits.size());
-    if (min_size > karatsuba_threshold) {
-        return *this = karatsuba_multiply(*this, x);
-    } else {
-        return *this = school_multiply(*this, x);
-    }
+    if (x == 0u || *this == 0u) return *this = 0u;
+    if (&x == this) return *this = square();
+    digit_view a = digits(), b = x.digits();
+    digit_vector product(a.size() + b.size());
+    digit_vector scratch(detail::multiply_scratch_size(a.size(), b.size()));
+    detail::multiply(product.data(), a.data(), a.size(), 
+                     b.data(), b.size(), scratch.data());
+    return *this = big_uint(move(product));
 }
 
 big_uint & big_uint::operator/=(const big_uint & x) {
@@ -442,42 +434,20 @@ big_uint big_uint::div(const big_uint & dividend, const big_uint & divisor,
         reminder = dividend;
         return { };
     }
-    if (divisor == 1u) {
-        reminder = { };
-        return dividend;
-    }
-    auto it = dividend._digits.rbegin();
-    auto end = dividend._digits.rend();
-    big_uint quot{ 1u };
-    reminder = { };
-    int i = 8 * sizeof(digit) - 1;
-    while (true) {
-        for (; i >= 0 && reminder < divisor; --i) {
-            reminder *= 2;
-            if ((*it >> i) & 0x1)
-                ++reminder;
-        }
-        if (reminder >= divisor)
-            break;
-        ++it;
-        i = 8 * sizeof(digit) - 1;
+    digit_view a = dividend.digits(), b = divisor.digits();
+    if (b.size() == 1) {
+        digit rem;
+        big_uint quot = div(dividend, b[0], rem);
+        reminder = rem;
+        return quot;
     }
-    reminder -= divisor;
-    while (it != end) {
-        for (; i >= 0; --i) {
-            reminder *= 2;
-            if ((*it >> i) & 0x1)
-                ++reminder;
-            quot *= 2;
-            if (reminder >= divisor) {
-                ++quot;
-                reminder -= divisor;
-            }
-        }
-        ++it;
-        i = 8 * sizeof(digit) - 1;
-    }
-    return quot;
+    digit_vector quot(a.size() - b.size() + 1);
+    digit_vector rem(b.size());
+    digit_vector scratch(detail::divide_scratch_size(a.size(), b.size()));
+    detail::divide(quot.data(), rem.data(), a.data(), a.size(),
+                   b.data(), b.size(), scratch.data());
+    reminder = big_uint(move(rem));
+    return big_uint(move(quot));
 }
 
 big_uint big_uint::div(const big_uint & dividend, const big_uint & divisor) {
@@ -532,7 +502,7 @@ bool operator>(long_digit lhs, const big_uint & rhs) {
 }
 
 bool operator<=(long_digit lhs, const big_uint & rhs) {
-    if (rhs._digits.size() > 2) return false;
+    if (rhs._digits.size() > 2) return true;
     long_digit right = (rhs._digits.size() == 1 ? 0 : rhs._digits[1]);
     right <<= 8 * sizeof(digit);
     right |= rhs._digits[0];
@@ -576,58 +546,10 @@ bool operator>=(const big_uint & lhs, long_digit rhs) {
 }
 
 bool operator==(const big_uint & lhs, long_digit rhs) {
-    return lhs == rhs;
-}
-
-bool operator!=(const big_uint & lhs, long_digit rhs) {
-    return !(lhs == rhs);
-}
-
-bool operator<(digit lhs, const big_uint & rhs) {
-    return rhs._digits.size() > 1 || lhs < rhs._digits[0];
-}
-
-bool operator>(digit lhs, const big_uint & rhs) {
-    return rhs._digits.size() == 1 && lhs > rhs._digits[0];
-}
-
-bool operator<=(digit lhs, const big_uint & rhs) {
-    return rhs._digits.size() > 1 || lhs <= rhs._digits[0];
-}
-
-bool operator>=(digit lhs, const big_uint & rhs) {
-    return rhs._digits.size() == 1 && lhs >= rhs._digits[0];
-}
-
-bool operator==(digit lhs, const big_uint & rhs) {
-    return rhs._digits.size() == 1 && rhs._digits[0] == lhs;
-}
-
-bool operator!=(digit lhs, const big_uint & rhs) {
-    return !(lhs == rhs);
-}
-
-bool operator<(const big_uint & lhs, digit rhs) {
-    return rhs > lhs;
-}
-
-bool operator>(const big_uint & lhs, digit rhs) {
-    return rhs < lhs;
-}
-
-bool operator<=(const big_uint & lhs, digit rhs) {
-    return rhs >= lhs;
-}
-
-bool operator>=(const big_uint & lhs, digit rhs) {
-    return rhs <= lhs;
-}
-
-bool operator==(const big_uint & lhs, digit rhs) {
     return rhs == lhs;
 }
 
-bool operator!=(const big_uint & lhs, digit rhs) {
+bool operator!=(const big_uint & lhs, long_digit rhs) {
     return !(lhs == rhs);
 }
 
@@ -639,40 +561,93 @@ big_uint big_uint::pow(digit e) const {
     big_uint x{ *this };
     big_uint y{ 1 };
     while (e > 1) {
-        if (e & 1) {
+        if (e & 1)
             y *= x;
-            x *= x;
-        } else
-            x *= x;
+        x = x.square();
         e >>= 1;
     }
     return x * y;
 }
 
+big_uint big_uint::square() const {
+    digit_view a = digits();
+    digit_vector product(2 * a.size());
+    digit_vector scratch(detail::square_scratch_size(a.size()));
+    detail::square(product.data(), a.data(), a.size(), scratch.data());
+    return big_uint(move(product));
+}
+
 bool big_uint::satisfies_invariant() const {
     return _digits.size() == 1 ||
         (_digits.size() > 1 && _digits.back() != 0);
 }
 
-ostream & operator<<(ostream & os, big_uint x) {
-    if (x == 0u)
-        return os << '0';
-    vector<char> result;
-    digit rem;
-    while (x != 0u) {
-        x = big_uint::div(x, 10, rem);
-        result.push_back('0' + rem);
+namespace {
+
+// The base selected by the basefield of the stream flags, as for built-in integers.
+unsigned stream_base(ios_base::fmtflags flags) {
+    switch (flags & ios_base::basefield) {
+    case ios_base::hex: return 16;
+    case ios_base::oct: return 8;
+    default: return 10;
+    }
+}
+
+}
+
+/*
+ * Short numbers are formatted on the stack, long ones written in chunks
+ * rather than formatted whole first.
+ */
+ostream & operator<<(ostream & os, const big_uint & x) {
+    ios_base::fmtflags flags = os.flags();
+    unsigned base = stream_base(flags);
+    if ((flags & ios_base::showbase) && x != 0u) {
+        if (base == 16) os.write(flags & ios_base::uppercase ? "0X" : "0x", 2);
+        if (base == 8) os.put('0');
+    }
+    bool upper = base == 16 && (flags & ios_base::uppercase);
+    auto write = [&os, upper](char * p, size_t n) {
+        if (upper) transform(p, p + n, p, [](char c) { return c >= 'a' ? c - 'a' + 'A' : c; });
+        os.write(p, n);
+    };
+    size_t n = x.digits().size();
+    char buffer[1024];
+    size_t length = detail::radix_size(n, base);
+    if (n < detail::radix_threshold && length <= sizeof(buffer)) {
+        char * last = buffer + length;
+        detail::write_radix(buffer, last, x, base);
+        char * first = find_if(buffer, last - 1, [](char c) { return c != '0'; });
+        write(first, last - first);
+    } else {
+        detail::stream_radix(x, base, 1 << 16, write);
     }
-    copy(result.rbegin(), result.rend(), ostream_iterator<char>(os));
     return os;
 }
 
+/*
+ * Digits are read in the base of the stream flags. Like for built-in
+ * integers, hexadecimal may start with 0x and without a basefield the prefix
+ * 0x or 0 selects the base.
+ */
 istream & operator>>(istream & is, big_uint & x) {
-    x = { 0u };
-    for (istreambuf_iterator<char> it{ is }, end; it != end && isdigit(*it); ++it) {
-        x *= 10;
-        x += *it - '0';
+    ios_base::fmtflags field = is.flags() & ios_base::basefield;
+    unsigned base = stream_base(field);
+    string s;
+    istreambuf_iterator<char> it{ is }, end;
+    if ((field == ios_base::hex || !field) && it != end && *it == '0') {
+        s.push_back(*it++);
+        if (it != end && (*it == 'x' || *it == 'X')) {
+            ++it;
+            base = 16;
+        } else if (!field) {
+            base = 8;
+        }
+    }
+    for (; it != end && detail::char_value(*it, base) < base; ++it) {
+        s.push_back(*it);
     }
+    x = detail::read_radix(s.data(), s.data() + s.size(), base);
     return is;
 }
 
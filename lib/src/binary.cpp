@@ -0,0 +1,178 @@
+#include "binary.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace big {
+
+using namespace std;
+
+namespace {
+
+const char magic[4] = { 'b', 'i', 'g', 'n' };
+const size_t header_size = 8;
+
+const bool little_endian = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+[[noreturn]] void malformed(const char * what) {
+    throw runtime_error(string("big::binary_reader: ") + what);
+}
+
+}
+
+binary_writer::binary_writer(ostream & os) : _os(os), _offset(header_size) {
+    const char header[header_size] = {
+        magic[0], magic[1], magic[2], magic[3],
+        char(binary_version), char(sizeof(digit)), 0, 0
+    };
+    _os.write(header, header_size);
+}
+
+void binary_writer::write(bool negative, digit_view digits) {
+    size_t n = digits.size() == 1 && digits[0] == 0 ? 0 : digits.size();
+    // At most 10 bytes of varint and 7 of padding.
+    char buffer[24];
+    size_t length = 0;
+    unsigned long long tag = 2ull * n + negative;
+    do {
+        buffer[length++] = char((tag & 0x7f) | (tag >= 0x80 ? 0x80 : 0));
+        tag >>= 7;
+    } while (tag);
+    while (n && (_offset + length) % sizeof(digit)) buffer[length++] = 0;
+    _os.write(buffer, length);
+    _offset += length + n * sizeof(digit);
+    if (little_endian) {
+        _os.write(reinterpret_cast<const char *>(digits.data()), n * sizeof(digit));
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t b = 0; b < sizeof(digit); ++b) _os.put(char(digits[i] >> 8 * b));
+    }
+}
+
+binary_writer & binary_writer::write(const big_uint & x) {
+    write(false, x.digits());
+    return *this;
+}
+
+binary_writer & binary_writer::write(const big_int & x) {
+    write(x._sign == big_int::sign_t::MINUS, x._modulus.digits());
+    return *this;
+}
+
+mapped_file::mapped_file(const string & path) : _data(nullptr), _size(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw system_error(errno, generic_category(), path);
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        int error = errno;
+        ::close(fd);
+        throw system_error(error, generic_category(), path);
+    }
+    _size = st.st_size;
+    if (_size) {
+        void * p = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw system_error(error, generic_category(), path);
+        }
+        _data = static_cast<char *>(p);
+    }
+    ::close(fd);
+}
+
+mapped_file::~mapped_file() {
+    if (_data) ::munmap(_data, _size);
+}
+
+binary_reader::binary_reader(const char * first, const char * last)
+    : _first(first), _pos(first), _last(last), _limb_bytes(0), _file(nullptr) {
+    if (size_t(last - first) < header_size || memcmp(first, magic, sizeof(magic))) {
+        malformed("missing header");
+    }
+    if (static_cast<unsigned char>(first[4]) > binary_version) malformed("unknown version");
+    _limb_bytes = first[5];
+    if (_limb_bytes != 4 && _limb_bytes != 8) malformed("bad limb size");
+    _pos += header_size;
+}
+
+binary_reader::binary_reader(const mapped_file & file)
+    : binary_reader(file.data(), file.data() + file.size()) {
+    _file = &file;
+}
+
+// Reads the tag of the next number, returns its limbs.
+const char * binary_reader::next(bool & negative, size_t & n) {
+    unsigned long long tag = 0;
+    for (unsigned s = 0; ; s += 7) {
+        if (_pos == _last) malformed("truncated number");
+        unsigned char c = *_pos++;
+        if (s > 63 || (s == 63 && c > 1)) malformed("bad length");
+        tag |= static_cast<unsigned long long>(c & 0x7f) << s;
+        if (!(c & 0x80)) break;
+    }
+    negative = tag & 1;
+    n = tag >> 1;
+    size_t pad = n ? (_limb_bytes - (_pos - _first) % _limb_bytes) % _limb_bytes : 0;
+    if (size_t(_last - _pos) < pad || (size_t(_last - _pos) - pad) / _limb_bytes < n) {
+        malformed("truncated number");
+    }
+    const char * limbs = _pos + pad;
+    _pos = limbs + n * _limb_bytes;
+    if (n == 0 ? negative : all_of(_pos - _limb_bytes, _pos, [](char c) { return !c; })) {
+        malformed("non-canonical number");
+    }
+    return limbs;
+}
+
+big_uint binary_reader::take(const char * limbs, size_t n) const {
+    if (!n) return big_uint();
+    if (_file && little_endian && _limb_bytes == sizeof(digit) &&
+        reinterpret_cast<uintptr_t>(limbs) % alignof(digit) == 0) {
+        return big_uint(digit_vector::borrow(reinterpret_cast<const digit *>(limbs), n));
+    }
+    size_t bytes = n * _limb_bytes;
+    digit_vector d((bytes + sizeof(digit) - 1) / sizeof(digit));
+    if (little_endian) {
+        memcpy(d.data(), limbs, bytes);
+    } else {
+        for (size_t i = 0; i < bytes; ++i) {
+            d[i / sizeof(digit)] |= digit(static_cast<unsigned char>(limbs[i]))
+                                    << 8 * (i % sizeof(digit));
+        }
+    }
+    return big_uint(move(d));
+}
+
+bool binary_reader::read(big_uint & x) {
+    if (at_end()) return false;
+    bool negative;
+    size_t n;
+    const char * limbs = next(negative, n);
+    if (negative) malformed("negative number read as big_uint");
+    x = take(limbs, n);
+    return true;
+}
+
+bool binary_reader::read(big_int & x) {
+    if (at_end()) return false;
+    bool negative;
+    size_t n;
+    const char * limbs = next(negative, n);
+    x._modulus = take(limbs, n);
+    x._sign = negative ? big_int::sign_t::MINUS : big_int::sign_t::PLUS;
+    return true;
+}
+
+}
@@ -0,0 +1,112 @@
+#include "charconv.hpp"
+#include "digit_ops.hpp"
+#include "radix.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace big {
+
+using namespace std;
+
+namespace {
+
+/*
+ * A number of b bits has between (b - 1) log_base(2) and b log_base(2)
+ * characters, so its length is low or high, with high - low <= 1 unless the
+ * base is 2. Powers of two are exact.
+ */
+void size_bounds(const big_uint & x, int base, size_t & low, size_t & high) {
+    digit_view d = x.digits();
+    size_t bits = d.size() * detail::digit_bits - detail::leading_zeros(d.back() | 1);
+    if (!(base & (base - 1))) {
+        unsigned s = __builtin_ctz(base);
+        low = high = max<size_t>((bits + s - 1) / s, 1);
+        return;
+    }
+    double ratio = 1 / log2(base);
+    low = static_cast<size_t>((bits - 1) * ratio * (1 - 1e-12)) + 1;
+    high = static_cast<size_t>(bits * ratio * (1 + 1e-12)) + 1;
+}
+
+}
+
+/*
+ * The number is converted into the upper bound of its length and a leading
+ * zero trimmed. Only a range shorter than that needs the exact length.
+ */
+to_chars_result to_chars(char * first, char * last, const big_uint & x, int base) {
+    assert(base >= 2 && base <= 36);
+    size_t space = last - first;
+    size_t low, high;
+    size_bounds(x, base, low, high);
+    size_t size = high;
+    if (space < high) {
+        if (space < low || detail::at_least_power(x, base, space)) {
+            return { last, errc::value_too_large };
+        }
+        size = space;
+    }
+    detail::write_radix(first, first + size, x, base);
+    char * lead = find_if(first, first + size - 1, [](char c) { return c != '0'; });
+    return { lead == first ? first + size : copy(lead, first + size, first), errc() };
+}
+
+to_chars_result to_chars(char * first, char * last, const big_int & x, int base) {
+    if (x._sign == big_int::sign_t::MINUS) {
+        if (first == last) return { last, errc::value_too_large };
+        *first++ = '-';
+    }
+    return to_chars(first, last, x._modulus, base);
+}
+
+size_t to_chars_size(const big_uint & x, int base) {
+    assert(base >= 2 && base <= 36);
+    size_t low, high;
+    size_bounds(x, base, low, high);
+    size_t size = high;
+    while (size > low && !detail::at_least_power(x, base, size - 1)) --size;
+    return size;
+}
+
+size_t to_chars_size(const big_int & x, int base) {
+    return (x._sign == big_int::sign_t::MINUS) + to_chars_size(x._modulus, base);
+}
+
+string to_string(const big_uint & x, int base) {
+    string s(to_chars_size(x, base), '0');
+    detail::write_radix(&s[0], &s[0] + s.size(), x, base);
+    return s;
+}
+
+string to_string(const big_int & x, int base) {
+    string s(to_chars_size(x, base), '0');
+    to_chars(&s[0], &s[0] + s.size(), x, base);
+    return s;
+}
+
+from_chars_result from_chars(const char * first, const char * last, big_uint & x,
+                             int base) {
+    assert(base >= 2 && base <= 36);
+    const char * end = detail::scan_radix(first, last, base);
+    if (end == first) return { first, errc::invalid_argument };
+    x = detail::read_radix(first, end, base);
+    return { end, errc() };
+}
+
+from_chars_result from_chars(const char * first, const char * last, big_int & x,
+                             int base) {
+    assert(base >= 2 && base <= 36);
+    const char * p = first;
+    bool negative = p != last && *p == '-';
+    if (negative) ++p;
+    const char * end = detail::scan_radix(p, last, base);
+    if (end == p) return { first, errc::invalid_argument };
+    x._modulus = detail::read_radix(p, end, base);
+    x._sign = negative ? big_int::sign_t::MINUS : big_int::sign_t::PLUS;
+    x.fix_zero();
+    return { end, errc() };
+}
+
+}
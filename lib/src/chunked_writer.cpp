@@ -0,0 +1,51 @@
+#include "chunked_writer.hpp"
+#include "radix.hpp"
+
+#include <cassert>
+#include <cerrno>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace big {
+
+using namespace std;
+
+namespace {
+
+// Writes all of [p, p + n) to fd, resuming after partial writes and signals.
+void write_all(int fd, const char * p, size_t n) {
+    while (n) {
+        ssize_t written = ::write(fd, p, n);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw system_error(errno, generic_category(), "big::write_chunked");
+        }
+        p += written;
+        n -= written;
+    }
+}
+
+}
+
+void write_chunked(ostream & os, const big_uint & x, int base, size_t chunk_size) {
+    assert(base >= 2 && base <= 36);
+    detail::stream_radix(x, base, chunk_size, [&os](char * p, size_t n) { os.write(p, n); });
+}
+
+void write_chunked(ostream & os, const big_int & x, int base, size_t chunk_size) {
+    if (x._sign == big_int::sign_t::MINUS) os.put('-');
+    write_chunked(os, x._modulus, base, chunk_size);
+}
+
+void write_chunked(int fd, const big_uint & x, int base, size_t chunk_size) {
+    assert(base >= 2 && base <= 36);
+    detail::stream_radix(x, base, chunk_size, [fd](char * p, size_t n) { write_all(fd, p, n); });
+}
+
+void write_chunked(int fd, const big_int & x, int base, size_t chunk_size) {
+    if (x._sign == big_int::sign_t::MINUS) write_all(fd, "-", 1);
+    write_chunked(fd, x._modulus, base, chunk_size);
+}
+
+}
@@ -0,0 +1,129 @@
+#include "digit_allocator.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+namespace big {
+
+using namespace std;
+
+namespace {
+
+class heap_allocator_t : public digit_allocator {
+public:
+    digit * allocate(size_t n) override {
+        return static_cast<digit *>(::operator new(n * sizeof(digit)));
+    }
+
+    void deallocate(digit * p, size_t) override {
+        ::operator delete(p);
+    }
+};
+
+// Smallest and largest pooled buffers are 2^min_class and 2^max_class digits.
+const size_t min_class = 3;
+const size_t max_class = 20;
+
+atomic<size_t> pool_cache_limit{ 1 << 20 };
+
+/*
+ * Free buffers of one thread. Each free buffer stores the pointer to the next
+ * one of the same class in its first bytes.
+ */
+struct pool_cache {
+    digit * heads[max_class + 1] = { };
+    size_t  counts[max_class + 1] = { };
+
+    ~pool_cache();
+};
+
+// Stays true after the cache of the thread is destroyed.
+thread_local bool pool_cache_destroyed = false;
+
+pool_cache::~pool_cache() {
+    for (size_t c = min_class; c <= max_class; ++c) {
+        while (heads[c]) {
+            digit * next;
+            memcpy(&next, heads[c], sizeof(next));
+            ::operator delete(heads[c]);
+            heads[c] = next;
+        }
+    }
+    pool_cache_destroyed = true;
+}
+
+pool_cache * thread_pool_cache() {
+    if (pool_cache_destroyed) return nullptr;
+    thread_local pool_cache cache;
+    return &cache;
+}
+
+size_t size_class(size_t n) {
+    size_t c = min_class;
+    while ((size_t(1) << c) < n) ++c;
+    return c;
+}
+
+class pool_allocator_t : public heap_allocator_t {
+public:
+    size_t round_up(size_t n) const override {
+        if (n > (size_t(1) << max_class)) return n;
+        return size_t(1) << size_class(n);
+    }
+
+    digit * allocate(size_t n) override {
+        pool_cache * cache = thread_pool_cache();
+        if (n > (size_t(1) << max_class) || !cache)
+            return heap_allocator_t::allocate(n);
+        size_t c = size_class(n);
+        digit * p = cache->heads[c];
+        if (!p) return heap_allocator_t::allocate(size_t(1) << c);
+        memcpy(&cache->heads[c], p, sizeof(p));
+        --cache->counts[c];
+        return p;
+    }
+
+    void deallocate(digit * p, size_t n) override {
+        pool_cache * cache = thread_pool_cache();
+        if (n > (size_t(1) << max_class) || !cache)
+            return heap_allocator_t::deallocate(p, n);
+        size_t c = size_class(n);
+        size_t limit = pool_cache_limit.load(memory_order_relaxed);
+        size_t cached = (cache->counts[c] + 1) * (sizeof(digit) << c);
+        if (cache->counts[c] && cached > limit)
+            return heap_allocator_t::deallocate(p, n);
+        memcpy(p, &cache->heads[c], sizeof(p));
+        cache->heads[c] = p;
+        ++cache->counts[c];
+    }
+};
+
+heap_allocator_t heap;
+pool_allocator_t pool;
+
+thread_local digit_allocator * current_allocator = &pool;
+
+}
+
+digit_allocator & heap_allocator() {
+    return heap;
+}
+
+digit_allocator & pool_allocator() {
+    return pool;
+}
+
+void set_pool_cache_limit(size_t bytes) {
+    pool_cache_limit.store(bytes, memory_order_relaxed);
+}
+
+digit_allocator & default_allocator() {
+    return *current_allocator;
+}
+
+void set_default_allocator(digit_allocator & alloc) {
+    current_allocator = &alloc;
+}
+
+}
@@ -0,0 +1,161 @@
+#include "digit_ops.hpp"
+
+#include <algorithm>
+
+namespace big {
+namespace detail {
+
+using namespace std;
+
+int compare(const digit * a, const digit * b, size_t n) {
+    while (n--) {
+        if (a[n] != b[n]) return a[n] < b[n] ? -1 : 1;
+    }
+    return 0;
+}
+
+int compare(const digit * a, size_t an, const digit * b, size_t bn) {
+    an = normalized_size(a, an);
+    bn = normalized_size(b, bn);
+    if (an != bn) return an < bn ? -1 : 1;
+    return compare(a, b, an);
+}
+
+digit add_n(digit * r, const digit * a, const digit * b, size_t n) {
+    digit carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        long_digit t = static_cast<long_digit>(a[i]) + b[i] + carry;
+        r[i] = t;
+        carry = t >> digit_bits;
+    }
+    return carry;
+}
+
+digit add_1(digit * r, const digit * a, size_t n, digit d) {
+    for (size_t i = 0; i < n; ++i) {
+        digit t = a[i] + d;
+        d = t < d;
+        r[i] = t;
+        if (!d) {
+            if (r != a) copy(a + i + 1, a + n, r + i + 1);
+            return 0;
+        }
+    }
+    return d;
+}
+
+digit add(digit * r, const digit * a, size_t an, const digit * b, size_t bn) {
+    digit carry = add_n(r, a, b, bn);
+    return add_1(r + bn, a + bn, an - bn, carry);
+}
+
+digit sub_n(digit * r, const digit * a, const digit * b, size_t n) {
+    digit borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        long_digit t = static_cast<long_digit>(a[i]) - b[i] - borrow;
+        r[i] = t;
+        borrow = (t >> digit_bits) & 1;
+    }
+    return borrow;
+}
+
+digit sub_1(digit * r, const digit * a, size_t n, digit d) {
+    for (size_t i = 0; i < n; ++i) {
+        digit t = a[i];
+        r[i] = t - d;
+        d = t < d;
+        if (!d) {
+            if (r != a) copy(a + i + 1, a + n, r + i + 1);
+            return 0;
+        }
+    }
+    return d;
+}
+
+digit sub(digit * r, const digit * a, size_t an, const digit * b, size_t bn) {
+    digit borrow = sub_n(r, a, b, bn);
+    return sub_1(r + bn, a + bn, an - bn, borrow);
+}
+
+bool abs_diff(digit * r, const digit * a, size_t an,
+              const digit * b, size_t bn) {
+    if (normalized_size(a, an) <= bn && compare(a, b, bn) < 0) {
+        sub_n(r, b, a, bn);
+        fill(r + bn, r + an, 0);
+        return true;
+    }
+    sub(r, a, an, b, bn);
+    return false;
+}
+
+digit lshift(digit * r, const digit * a, size_t n, unsigned s) {
+    digit out = 0;
+    for (size_t i = 0; i < n; ++i) {
+        digit t = a[i];
+        r[i] = (t << s) | out;
+        out = t >> (digit_bits - s);
+    }
+    return out;
+}
+
+digit rshift(digit * r, const digit * a, size_t n, unsigned s) {
+    digit out = 0;
+    for (size_t i = n; i-- > 0; ) {
+        digit t = a[i];
+        r[i] = (t >> s) | out;
+        out = t << (digit_bits - s);
+    }
+    return out >> (digit_bits - s);
+}
+
+/*
+ * Exact division by multiplication with the inverse of d modulo B. See
+ * T. Granlund, P. Montgomery "Division by invariant integers using
+ * multiplication".
+ */
+void divexact_1(digit * r, const digit * a, size_t n, digit d) {
+    digit inverse = d;
+    for (int i = 0; i < 6; ++i) inverse *= 2 - d * inverse;
+    digit borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        digit t = a[i];
+        digit c = t < borrow;
+        digit q = (t - borrow) * inverse;
+        r[i] = q;
+        borrow = (static_cast<long_digit>(q) * d >> digit_bits) + c;
+    }
+}
+
+digit mul_1(digit * r, const digit * a, size_t n, digit d) {
+    digit carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        long_digit t = static_cast<long_digit>(a[i]) * d + carry;
+        r[i] = t;
+        carry = t >> digit_bits;
+    }
+    return carry;
+}
+
+digit addmul_1(digit * r, const digit * a, size_t n, digit d) {
+    digit carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        long_digit t = static_cast<long_digit>(a[i]) * d + r[i] + carry;
+        r[i] = t;
+        carry = t >> digit_bits;
+    }
+    return carry;
+}
+
+digit submul_1(digit * r, const digit * a, size_t n, digit d) {
+    digit borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        long_digit t = static_cast<long_digit>(a[i]) * d + borrow;
+        digit lo = t;
+        borrow = (t >> digit_bits) + (r[i] < lo);
+        r[i] -= lo;
+    }
+    return borrow;
+}
+
+}
+}
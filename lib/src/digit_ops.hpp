@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstddef>
+
+#include "digit.hpp"
+
+/*
+ * Low level routines working on ranges of digits, least significant digit
+ * first. A range is a pointer and a length. Unless told otherwise the result
+ * may coincide with the first operand but must not partially overlap any of
+ * the operands. None of the routines allocate.
+ */
+namespace big {
+namespace detail {
+
+const unsigned digit_bits = 8 * sizeof(digit);
+
+// Tuning parameters. Accessed through big_uint setters.
+extern std::size_t karatsuba_threshold;
+extern std::size_t toom3_threshold;
+extern std::size_t toom4_threshold;
+extern std::size_t ntt_threshold;
+extern std::size_t karatsuba_square_threshold;
+extern std::size_t burnikel_ziegler_threshold;
+extern std::size_t newton_threshold;
+
+// Length of a without leading zero digits. Zero has length 0.
+inline std::size_t normalized_size(const digit * a, std::size_t n) {
+    while (n && !a[n - 1]) --n;
+    return n;
+}
+
+// Number of leading zero bits of d != 0.
+inline unsigned leading_zeros(digit d) {
+    return __builtin_clzll(d) - (64 - digit_bits);
+}
+
+int compare(const digit * a, const digit * b, std::size_t n);
+int compare(const digit * a, std::size_t an, const digit * b, std::size_t bn);
+
+// r = a + b, returns carry. an >= bn, r has an digits.
+digit add_n(digit * r, const digit * a, const digit * b, std::size_t n);
+digit add_1(digit * r, const digit * a, std::size_t n, digit d);
+digit add(digit * r, const digit * a, std::size_t an,
+          const digit * b, std::size_t bn);
+
+// r = a - b, returns borrow. an >= bn, r has an digits.
+digit sub_n(digit * r, const digit * a, const digit * b, std::size_t n);
+digit sub_1(digit * r, const digit * a, std::size_t n, digit d);
+digit sub(digit * r, const digit * a, std::size_t an,
+          const digit * b, std::size_t bn);
+
+/*
+ * r = |a - b|, an >= bn, r has an digits. Returns true if a < b.
+ */
+bool abs_diff(digit * r, const digit * a, std::size_t an,
+              const digit * b, std::size_t bn);
+
+// r = a << s, returns the bits shifted out. 0 < s < digit_bits.
+digit lshift(digit * r, const digit * a, std::size_t n, unsigned s);
+// r = a >> s, returns the bits shifted out. 0 < s < digit_bits.
+digit rshift(digit * r, const digit * a, std::size_t n, unsigned s);
+
+// r = a / d, where a is known to be divisible by odd d.
+void divexact_1(digit * r, const digit * a, std::size_t n, digit d);
+
+// r = a * d, returns the high digit.
+digit mul_1(digit * r, const digit * a, std::size_t n, digit d);
+// r += a * d, returns the high digit.
+digit addmul_1(digit * r, const digit * a, std::size_t n, digit d);
+// r -= a * d, returns the borrowed digit.
+digit submul_1(digit * r, const digit * a, std::size_t n, digit d);
+
+/*
+ * r = a * b. r has an + bn digits and overlaps neither a nor b. The scratch
+ * area must hold multiply_scratch_size(an, bn) digits.
+ */
+void multiply(digit * r, const digit * a, std::size_t an,
+              const digit * b, std::size_t bn, digit * scratch);
+std::size_t multiply_scratch_size(std::size_t an, std::size_t bn);
+
+// The same as multiply but with a fixed algorithm on the top level.
+void unbalanced_multiply(digit * r, const digit * a, std::size_t an,
+                         const digit * b, std::size_t bn, digit * scratch);
+std::size_t unbalanced_scratch_size(std::size_t an, std::size_t bn);
+void school_multiply(digit * r, const digit * a, std::size_t an,
+                     const digit * b, std::size_t bn);
+void karatsuba_multiply(digit * r, const digit * a, std::size_t an,
+                        const digit * b, std::size_t bn, digit * scratch);
+std::size_t karatsuba_scratch_size(std::size_t an, std::size_t bn);
+void toom3_multiply(digit * r, const digit * a, std::size_t an,
+                    const digit * b, std::size_t bn, digit * scratch);
+std::size_t toom3_scratch_size(std::size_t an, std::size_t bn);
+void toom4_multiply(digit * r, const digit * a, std::size_t an,
+                    const digit * b, std::size_t bn, digit * scratch);
+std::size_t toom4_scratch_size(std::size_t an, std::size_t bn);
+
+// Whether the product of an and bn digits is within reach of ntt_multiply.
+bool ntt_supports(std::size_t an, std::size_t bn);
+void ntt_multiply(digit * r, const digit * a, std::size_t an,
+                  const digit * b, std::size_t bn, digit * scratch);
+std::size_t ntt_scratch_size(std::size_t an, std::size_t bn);
+
+/*
+ * r = a * a. r has 2n digits and doesn't overlap a. The scratch area must
+ * hold square_scratch_size(n) digits.
+ */
+void square(digit * r, const digit * a, std::size_t n, digit * scratch);
+std::size_t square_scratch_size(std::size_t n);
+
+// The same as square but with a fixed algorithm on the top level.
+void school_square(digit * r, const digit * a, std::size_t n);
+void karatsuba_square(digit * r, const digit * a, std::size_t n, digit * scratch);
+std::size_t karatsuba_square_scratch_size(std::size_t n);
+void toom3_square(digit * r, const digit * a, std::size_t n, digit * scratch);
+std::size_t toom3_square_scratch_size(std::size_t n);
+void toom4_square(digit * r, const digit * a, std::size_t n, digit * scratch);
+std::size_t toom4_square_scratch_size(std::size_t n);
+
+/*
+ * Single digit divisor prepared for division without division instructions.
+ * See N. Moller, T. Granlund "Improved division by invariant integers".
+ * norm is the divisor shifted left by shift bits so that its top bit is set,
+ * v = floor((B^2 - 1) / norm) - B.
+ */
+struct divisor_1 {
+    digit    norm;
+    digit    v;
+    unsigned shift;
+
+    explicit divisor_1(digit d);
+};
+
+/*
+ * Divides <u1, u0> = u1 B + u0 by d = divisor_1::norm with its v, u1 < d.
+ * Returns the quotient, r gets the remainder. The first correction depends
+ * on the data in a way branch prediction can't follow, so it is done by a
+ * mask.
+ */
+inline digit divrem_2by1(digit & r, digit u1, digit u0, digit d, digit v) {
+    long_digit q = static_cast<long_digit>(v) * u1 +
+        ((static_cast<long_digit>(u1) << digit_bits) | u0);
+    digit q1 = static_cast<digit>(q >> digit_bits) + 1;
+    digit q0 = static_cast<digit>(q);
+    r = u0 - q1 * d;
+    digit mask = -static_cast<digit>(r > q0);
+    q1 += mask;
+    r += mask & d;
+    if (r >= d) {
+        ++q1;
+        r -= d;
+    }
+    return q1;
+}
+
+// q = a / d, returns a % d. q has n digits and may coincide with a.
+digit divrem_1(digit * q, const digit * a, std::size_t n, const divisor_1 & d);
+digit divrem_1(digit * q, const digit * a, std::size_t n, digit d);
+// a % d.
+digit mod_1(const digit * a, std::size_t n, const divisor_1 & d);
+
+/*
+ * Divides a by d, whose top bit is set. an >= dn >= 2. q gets the lower
+ * an - dn digits of the quotient, the top digit (0 or 1) is returned. The
+ * remainder replaces the lower dn digits of a, the rest of a becomes zero.
+ */
+digit school_divide(digit * q, digit * a, std::size_t an,
+                    const digit * d, std::size_t dn);
+
+/*
+ * The same as school_divide by the recursive algorithm of C. Burnikel,
+ * J. Ziegler "Fast recursive division". The scratch area must hold
+ * dc_divide_scratch_size(an, dn) digits.
+ */
+digit dc_divide(digit * q, digit * a, std::size_t an,
+                const digit * d, std::size_t dn, digit * scratch);
+std::size_t dc_divide_scratch_size(std::size_t an, std::size_t dn);
+
+/*
+ * v = floor(B^2n / d), where d has n digits and its top bit set. v has
+ * n + 1 digits. Computed by Newton iteration in about four multiplications
+ * of n digits. The scratch area must hold invert_scratch_size(n) digits.
+ */
+void invert(digit * v, const digit * d, std::size_t n, digit * scratch);
+std::size_t invert_scratch_size(std::size_t n);
+
+/*
+ * The same as school_divide, with v = invert(d) making each block of dn
+ * quotient digits cost two multiplications. dn may be 1. The scratch area
+ * must hold newton_divide_scratch_size(an, dn) digits.
+ */
+digit newton_divide(digit * q, digit * a, std::size_t an, const digit * d,
+                    std::size_t dn, const digit * v, digit * scratch);
+std::size_t newton_divide_scratch_size(std::size_t an, std::size_t dn);
+
+/*
+ * q = a / b, r = a % b, where b has bn >= 2 digits with a nonzero top
+ * digit, an >= bn. q has an - bn + 1 digits, r has bn digits. Neither
+ * overlaps the operands. The scratch area must hold
+ * divide_scratch_size(an, bn) digits.
+ */
+void divide(digit * q, digit * r, const digit * a, std::size_t an,
+            const digit * b, std::size_t bn, digit * scratch);
+std::size_t divide_scratch_size(std::size_t an, std::size_t bn);
+
+/*
+ * Montgomery reduction modulo an odd m of n digits, R = B^n. See
+ * P. Montgomery "Modular multiplication without trial division".
+ * montgomery_inverse returns -m0^-1 mod B for odd m0.
+ */
+digit montgomery_inverse(digit m0);
+/*
+ * r = t R^-1 mod m, where t < m R has 2n digits and is destroyed,
+ * minv = montgomery_inverse(m[0]). r has n digits and may coincide with t.
+ */
+void montgomery_reduce(digit * r, digit * t, const digit * m, std::size_t n,
+                       digit minv);
+
+/*
+ * Toom building blocks shared by multiplication and squaring. An operand is
+ * split into pieces of k digits, the last one may be shorter.
+ *
+ * toom_evaluate sets r = a_first + a_(first + step) v + a_(first + 2 step) v^2
+ * + ..., known to fit into k + 1 digits.
+ */
+void toom_evaluate(digit * r, const digit * a, std::size_t an, std::size_t k,
+                   std::size_t first, std::size_t step, digit v);
+
+/*
+ * plus = a(p), minus = |a(-p)|, where a is the polynomial with the pieces as
+ * coefficients. Returns true if a(-p) < 0. Each buffer has k + 1 digits, t is
+ * a temporary.
+ */
+bool toom_evaluate_pm(digit * plus, digit * minus, digit * t,
+                      const digit * a, std::size_t an, std::size_t k, digit p);
+
+/*
+ * Complete the product of rn digits in r, which holds c0 and the highest
+ * coefficient in place already. The values at the points have 2k + 2 digits
+ * each, the ones at negative points are given by the absolute value and
+ * sign. The values are destroyed.
+ */
+void toom3_interpolate(digit * r, std::size_t rn, std::size_t k,
+                       digit * w1, digit * wm1, bool negative, digit * w2);
+void toom4_interpolate(digit * r, std::size_t rn, std::size_t k,
+                       digit * w1, digit * wm1, bool negative1,
+                       digit * w2, digit * wm2, bool negative2, digit * w3);
+
+}
+}
@@ -0,0 +1,105 @@
+#include "digit_vector.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace big {
+
+using namespace std;
+
+constexpr digit_vector::size_type digit_vector::inline_capacity;
+
+digit_vector::digit_vector(size_type n, digit value) : digit_vector() {
+    resize(n, value);
+}
+
+digit_vector::digit_vector(initializer_list<digit> digits) : digit_vector() {
+    reserve(digits.size());
+    _size = digits.size();
+    copy(digits.begin(), digits.end(), _data);
+}
+
+digit_vector::digit_vector(const digit_vector & x) : digit_vector() {
+    reserve(x._size);
+    _size = x._size;
+    copy(x.begin(), x.end(), _data);
+}
+
+digit_vector::digit_vector(digit_vector && x) noexcept : digit_vector() {
+    swap(x);
+}
+
+digit_vector & digit_vector::operator=(const digit_vector & x) {
+    if (this == &x) return *this;
+    _size = 0;
+    reserve(x._size);
+    _size = x._size;
+    copy(x.begin(), x.end(), _data);
+    return *this;
+}
+
+digit_vector & digit_vector::operator=(digit_vector && x) noexcept {
+    if (this == &x) return *this;
+    _size = 0;
+    swap(x);
+    return *this;
+}
+
+digit_vector digit_vector::adopt(digit * data, size_type size, 
+                                 size_type capacity, digit_allocator & alloc) {
+    assert(capacity > 0 && size <= capacity);
+    digit_vector result(alloc);
+    result._data = data;
+    result._size = size;
+    result._capacity = capacity;
+    return result;
+}
+
+digit_vector digit_vector::borrow(const digit * data, size_type size) {
+    digit_vector result;
+    if (!size) return result;
+    result._data = const_cast<digit *>(data);
+    result._size = size;
+    result._capacity = 0;
+    return result;
+}
+
+void digit_vector::reallocate(size_type capacity) {
+    digit_allocator & alloc = get_allocator();
+    // Borrowed digits may be more than the capacity asked for.
+    capacity = alloc.round_up(max(capacity, _size));
+    digit * data = alloc.allocate(capacity);
+    copy(_data, _data + _size, data);
+    release();
+    _data = data;
+    _capacity = capacity;
+    _alloc = &alloc;
+}
+
+void digit_vector::release() {
+    if (is_inline()) return;
+    if (!is_borrowed()) _alloc->deallocate(_data, _capacity);
+    _data = _inline;
+    _capacity = inline_capacity;
+}
+
+void digit_vector::swap(digit_vector & x) noexcept {
+    if (!is_inline() && !x.is_inline()) {
+        std::swap(_data, x._data);
+    } else if (is_inline() && x.is_inline()) {
+        std::swap(_inline, x._inline);
+    } else if (is_inline()) {
+        copy(_inline, _inline + _size, x._inline);
+        _data = x._data;
+        x._data = x._inline;
+    } else {
+        copy(x._inline, x._inline + x._size, _inline);
+        x._data = _data;
+        _data = _inline;
+    }
+    std::swap(_size, x._size);
+    std::swap(_capacity, x._capacity);
+    std::swap(_alloc, x._alloc);
+}
+
+}
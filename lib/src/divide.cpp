@@ -0,0 +1,262 @@
+#include "digit_ops.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace big {
+namespace detail {
+
+using namespace std;
+
+size_t burnikel_ziegler_threshold = 40;
+
+divisor_1::divisor_1(digit d) {
+    shift = leading_zeros(d);
+    norm = d << shift;
+    long_digit t = (static_cast<long_digit>(~norm) << digit_bits) | ~digit(0);
+    v = t / norm;
+}
+
+/*
+ * The dividend is shifted together with the divisor on the fly. The bits
+ * shifted out of the top digit start the remainder, which stays shifted
+ * until the end.
+ */
+digit divrem_1(digit * q, const digit * a, size_t n, const divisor_1 & d) {
+    const digit norm = d.norm;
+    const digit v = d.v;
+    const unsigned s = d.shift;
+    digit r = 0;
+    if (s == 0) {
+        for (size_t i = n; i-- > 0; ) q[i] = divrem_2by1(r, r, a[i], norm, v);
+        return r;
+    }
+    digit hi = a[n - 1];
+    r = hi >> (digit_bits - s);
+    for (size_t i = n - 1; i > 0; --i) {
+        digit lo = a[i - 1];
+        q[i] = divrem_2by1(r, r, (hi << s) | (lo >> (digit_bits - s)), norm, v);
+        hi = lo;
+    }
+    q[0] = divrem_2by1(r, r, hi << s, norm, v);
+    return r >> s;
+}
+
+digit divrem_1(digit * q, const digit * a, size_t n, digit d) {
+    return divrem_1(q, a, n, divisor_1(d));
+}
+
+digit mod_1(const digit * a, size_t n, const divisor_1 & d) {
+    const digit norm = d.norm;
+    const digit v = d.v;
+    const unsigned s = d.shift;
+    digit r = 0;
+    if (s == 0) {
+        for (size_t i = n; i-- > 0; ) divrem_2by1(r, r, a[i], norm, v);
+        return r;
+    }
+    digit hi = a[n - 1];
+    r = hi >> (digit_bits - s);
+    for (size_t i = n - 1; i > 0; --i) {
+        digit lo = a[i - 1];
+        divrem_2by1(r, r, (hi << s) | (lo >> (digit_bits - s)), norm, v);
+        hi = lo;
+    }
+    divrem_2by1(r, r, hi << s, norm, v);
+    return r >> s;
+}
+
+/*
+ * D. Knuth "The Art of Computer Programming", vol. 2, 4.3.1, Algorithm D.
+ * Each quotient digit is estimated from the top three digits of the
+ * remainder and the top two digits of d, which makes the estimate at most
+ * one too large. That case is fixed by adding d back.
+ */
+digit school_divide(digit * q, digit * a, size_t an, const digit * d, size_t dn) {
+    assert(dn >= 2 && an >= dn);
+    assert(d[dn - 1] >> (digit_bits - 1));
+    const long_digit base = static_cast<long_digit>(1) << digit_bits;
+    const digit d1 = d[dn - 1];
+    const digit d0 = d[dn - 2];
+    digit qh = compare(a + an - dn, d, dn) >= 0;
+    if (qh) sub_n(a + an - dn, a + an - dn, d, dn);
+    for (size_t j = an - dn; j-- > 0; ) {
+        digit * r = a + j;
+        long_digit top = (static_cast<long_digit>(r[dn]) << digit_bits) | r[dn - 1];
+        long_digit qhat = top / d1;
+        long_digit rhat = top % d1;
+        while (qhat >= base ||
+               qhat * d0 > ((rhat << digit_bits) | r[dn - 2])) {
+            --qhat;
+            rhat += d1;
+            if (rhat >= base) break;
+        }
+        digit borrow = submul_1(r, d, dn, static_cast<digit>(qhat));
+        digit t = r[dn];
+        r[dn] = t - borrow;
+        if (t < borrow) {
+            --qhat;
+            r[dn] += add_n(r, r, d, dn);
+        }
+        q[j] = static_cast<digit>(qhat);
+    }
+    return qh;
+}
+
+namespace {
+
+size_t dc_threshold() {
+    return max<size_t>(burnikel_ziegler_threshold, 4);
+}
+
+digit dc_divide_n(digit * q, digit * a, const digit * d, size_t n, digit * scratch);
+
+/*
+ * Divides the dn + k digits of a by d, 0 < k < dn. The top 2k digits of a
+ * are divided by the top k digits of d, which overestimates the quotient by
+ * at most 2. Subtracting the quotient times the low dn - k digits of d gives
+ * the true remainder, or a negative one, which is fixed by adding d back.
+ */
+digit divide_block(digit * q, digit * a, size_t k, const digit * d, size_t dn,
+                   digit * scratch) {
+    size_t ln = dn - k;
+    digit qh = dc_divide_n(q, a + ln, d + ln, k, scratch);
+    digit * t = scratch;
+    multiply(t, q, k, d, ln, scratch + dn);
+    digit borrow = sub_n(a, a, t, dn);
+    if (qh) borrow += sub_n(a + k, a + k, d, ln);
+    while (borrow) {
+        qh -= sub_1(q, q, k, 1);
+        borrow -= add_n(a, a, d, dn);
+    }
+    return qh;
+}
+
+size_t dc_divide_n_scratch_size(size_t n);
+
+size_t divide_block_scratch_size(size_t k, size_t dn) {
+    return max(dc_divide_n_scratch_size(k),
+               dn + multiply_scratch_size(k, dn - k));
+}
+
+/*
+ * Divides the 2n digits of a by d of n digits as two blocks of about n / 2
+ * quotient digits.
+ */
+digit dc_divide_n(digit * q, digit * a, const digit * d, size_t n, digit * scratch) {
+    if (n < dc_threshold()) return school_divide(q, a, 2 * n, d, n);
+    size_t lo = n / 2;
+    size_t hi = n - lo;
+    digit qh = divide_block(q + lo, a + lo, hi, d, n, scratch);
+    digit ql = divide_block(q, a, lo, d, n, scratch);
+    assert(ql == 0);
+    (void) ql;
+    return qh;
+}
+
+size_t dc_divide_n_scratch_size(size_t n) {
+    if (n < dc_threshold()) return 0;
+    size_t lo = n / 2;
+    return max(divide_block_scratch_size(n - lo, n),
+               divide_block_scratch_size(lo, n));
+}
+
+}
+
+/*
+ * The quotient is produced in blocks of dn digits from the top, each block
+ * dividing the running remainder extended by the next digits of a. The
+ * first block takes the odd quotient digits.
+ */
+digit dc_divide(digit * q, digit * a, size_t an, const digit * d, size_t dn,
+                digit * scratch) {
+    size_t qn = an - dn;
+    digit qh = compare(a + qn, d, dn) >= 0;
+    if (qh) sub_n(a + qn, a + qn, d, dn);
+    for (size_t j = qn; j > 0; ) {
+        size_t k = j % dn ? j % dn : dn;
+        j -= k;
+        digit qk;
+        if (k < dc_threshold()) {
+            qk = school_divide(q + j, a + j, dn + k, d, dn);
+        } else if (k == dn) {
+            qk = dc_divide_n(q + j, a + j, d, dn, scratch);
+        } else {
+            qk = divide_block(q + j, a + j, k, d, dn, scratch);
+        }
+        assert(qk == 0);
+        (void) qk;
+    }
+    return qh;
+}
+
+size_t dc_divide_scratch_size(size_t an, size_t dn) {
+    size_t qn = an - dn;
+    size_t k = qn % dn;
+    size_t size = qn >= dn ? dc_divide_n_scratch_size(dn) : 0;
+    if (k >= dc_threshold()) size = max(size, divide_block_scratch_size(k, dn));
+    return size;
+}
+
+namespace {
+
+// The inverse pays off when it is used for a quotient as long as d.
+bool use_newton(size_t an, size_t bn) {
+    return bn >= newton_threshold && an >= 2 * bn;
+}
+
+bool use_dc(size_t an, size_t bn) {
+    return bn >= burnikel_ziegler_threshold && an >= bn + burnikel_ziegler_threshold;
+}
+
+}
+
+/*
+ * The operands are shifted so that the top bit of the divisor is set. The
+ * dividend gets one more digit to keep the bits shifted out, so the top
+ * digit of the quotient comes out of the loop rather than the return value.
+ */
+void divide(digit * q, digit * r, const digit * a, size_t an,
+            const digit * b, size_t bn, digit * scratch) {
+    assert(bn >= 2 && an >= bn && b[bn - 1]);
+    unsigned s = leading_zeros(b[bn - 1]);
+    digit * na = scratch;
+    digit * nb = scratch + an + 1;
+    if (s) {
+        lshift(nb, b, bn, s);
+        na[an] = lshift(na, a, an, s);
+    } else {
+        copy(b, b + bn, nb);
+        copy(a, a + an, na);
+        na[an] = 0;
+    }
+    digit qh;
+    if (use_newton(an, bn)) {
+        digit * v = nb + bn;
+        invert(v, nb, bn, v + bn + 1);
+        qh = newton_divide(q, na, an + 1, nb, bn, v, v + bn + 1);
+    } else if (use_dc(an, bn)) {
+        qh = dc_divide(q, na, an + 1, nb, bn, nb + bn);
+    } else {
+        qh = school_divide(q, na, an + 1, nb, bn);
+    }
+    assert(qh == 0);
+    (void) qh;
+    if (s) {
+        rshift(r, na, bn, s);
+    } else {
+        copy(na, na + bn, r);
+    }
+}
+
+size_t divide_scratch_size(size_t an, size_t bn) {
+    if (use_newton(an, bn)) {
+        return an + 1 + bn + bn + 1 +
+            max(invert_scratch_size(bn), newton_divide_scratch_size(an + 1, bn));
+    }
+    if (use_dc(an, bn)) return an + 1 + bn + dc_divide_scratch_size(an + 1, bn);
+    return an + 1 + bn;
+}
+
+}
+}
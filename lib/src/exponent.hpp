@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "digit_ops.hpp"
+#include "digit_view.hpp"
+
+namespace big {
+namespace detail {
+
+// Number of significant bits of e.
+inline std::size_t bit_length(digit_view e) {
+    std::size_t n = normalized_size(e.data(), e.size());
+    return n ? n * digit_bits - leading_zeros(e[n - 1]) : 0;
+}
+
+inline bool test_bit(digit_view e, std::size_t i) {
+    return e[i / digit_bits] >> (i % digit_bits) & 1;
+}
+
+// Bits i to j - 1 of e, j - i <= digit_bits.
+inline digit extract_bits(digit_view e, std::size_t i, std::size_t j) {
+    digit v = 0;
+    for (std::size_t k = j; k-- > i; ) v = v << 1 | test_bit(e, k);
+    return v;
+}
+
+/*
+ * Width of the sliding window for an exponent of the given bits, balancing
+ * the 2^(w - 1) table entries against the multiplications saved.
+ */
+inline unsigned window_size(std::size_t bits) {
+    static const std::size_t limits[] = { 8, 24, 80, 240, 672, 1792 };
+    unsigned w = 1;
+    while (w <= 6 && bits > limits[w - 1]) ++w;
+    return w;
+}
+
+/*
+ * The odd powers g, g^3, ..., g^(2^w - 1). Ring provides the type value,
+ * one(), multiply(r, a, b) and square(r, a), the results of which may
+ * coincide with an operand.
+ */
+template <typename Ring>
+std::vector<typename Ring::value> odd_powers(Ring & ring, const typename Ring::value & g,
+                                             unsigned w) {
+    using value = typename Ring::value;
+    std::vector<value> table(std::size_t(1) << (w - 1), g);
+    if (w > 1) {
+        value g2;
+        ring.square(g2, g);
+        for (std::size_t i = 1; i < table.size(); ++i) ring.multiply(table[i], table[i - 1], g2);
+    }
+    return table;
+}
+
+// g^e by left-to-right sliding windows.
+template <typename Ring>
+typename Ring::value sliding_window_pow(Ring & ring, const typename Ring::value & g,
+                                        digit_view e) {
+    using value = typename Ring::value;
+    std::size_t bits = bit_length(e);
+    if (!bits) return ring.one();
+    unsigned w = window_size(bits);
+    std::vector<value> table = odd_powers(ring, g, w);
+    value r;
+    bool first = true;
+    for (std::size_t top = bits; top; ) {
+        if (!test_bit(e, top - 1)) {
+            ring.square(r, r);
+            --top;
+            continue;
+        }
+        std::size_t low = top > w ? top - w : 0;
+        while (!test_bit(e, low)) ++low;
+        const value & t = table[extract_bits(e, low, top) >> 1];
+        if (first) {
+            r = t;
+            first = false;
+        } else {
+            for (std::size_t k = low; k < top; ++k) ring.square(r, r);
+            ring.multiply(r, r, t);
+        }
+        top = low;
+    }
+    return r;
+}
+
+/*
+ * Fixed-base comb of C. H. Lim and P. J. Lee "More flexible exponentiation
+ * with precomputation". An exponent of up to teeth * spacing bits is read as
+ * teeth rows of spacing bits, and the columns of each row as combs blocks of
+ * stride bits. For each block j the table holds the 2^teeth - 1 products of
+ * the g^(2^(i spacing + j stride)), so one pass over the stride bit positions
+ * takes stride squarings and up to spacing multiplications.
+ */
+struct comb_layout {
+    std::size_t teeth;
+    std::size_t combs;
+    std::size_t spacing;
+    std::size_t stride;
+
+    std::size_t bits() const { return teeth * spacing; }
+    std::size_t entries() const { return combs * ((std::size_t(1) << teeth) - 1); }
+};
+
+// The layout for exponents of the given bits doing least work in at most
+// max_entries table entries, max_entries >= 1.
+inline comb_layout choose_comb(std::size_t bits, std::size_t max_entries) {
+    bits = bits ? bits : 1;
+    comb_layout best = { 1, 1, bits, bits };
+    double best_cost = 2.0 * bits;
+    for (std::size_t h = 1; h <= 24 && h <= bits; ++h) {
+        std::size_t row = (std::size_t(1) << h) - 1;
+        if (row > max_entries) break;
+        std::size_t a = (bits + h - 1) / h;
+        for (std::size_t v = 1; v <= a && v * row <= max_entries; ++v) {
+            std::size_t b = (a + v - 1) / v;
+            // A column of a block is all zeros with probability 2^-h.
+            double cost = b + a * (1.0 - 1.0 / (row + 1));
+            if (cost < best_cost) {
+                best = { h, v, a, b };
+                best_cost = cost;
+            }
+        }
+    }
+    return best;
+}
+
+template <typename Ring>
+std::vector<typename Ring::value> comb_table(Ring & ring, const typename Ring::value & g,
+                                             const comb_layout & layout) {
+    using value = typename Ring::value;
+    std::size_t row = (std::size_t(1) << layout.teeth) - 1;
+    std::vector<value> table(layout.entries());
+    // The single teeth g^(2^(i spacing)) of block 0.
+    std::vector<value> teeth(layout.teeth, g);
+    for (std::size_t i = 1; i < layout.teeth; ++i) {
+        ring.square(teeth[i], teeth[i - 1]);
+        for (std::size_t k = 1; k < layout.spacing; ++k) ring.square(teeth[i], teeth[i]);
+    }
+    for (std::size_t j = 0; j < layout.combs; ++j) {
+        if (j) {
+            for (value & t : teeth) {
+                for (std::size_t k = 0; k < layout.stride; ++k) ring.square(t, t);
+            }
+        }
+        value * block = table.data() + j * row;
+        for (std::size_t u = 1; u <= row; ++u) {
+            std::size_t top = 0;
+            while (u >> (top + 1)) ++top;
+            std::size_t rest = u ^ std::size_t(1) << top;
+            if (rest) {
+                ring.multiply(block[u - 1], block[rest - 1], teeth[top]);
+            } else {
+                block[u - 1] = teeth[top];
+            }
+        }
+    }
+    return table;
+}
+
+// g^e from the comb_table of g, bit_length(e) <= layout.bits().
+template <typename Ring>
+typename Ring::value comb_pow(Ring & ring, const std::vector<typename Ring::value> & table,
+                              const comb_layout & layout, digit_view e) {
+    using value = typename Ring::value;
+    std::size_t bits = bit_length(e);
+    std::size_t row = (std::size_t(1) << layout.teeth) - 1;
+    value r;
+    bool first = true;
+    for (std::size_t k = layout.stride; k--; ) {
+        if (!first) ring.square(r, r);
+        for (std::size_t j = 0; j < layout.combs; ++j) {
+            std::size_t column = j * layout.stride + k;
+            if (column >= layout.spacing) break;
+            std::size_t u = 0;
+            for (std::size_t i = 0, bit = column; i < layout.teeth && bit < bits;
+                 ++i, bit += layout.spacing) {
+                u |= std::size_t(test_bit(e, bit)) << i;
+            }
+            if (!u) continue;
+            const value & t = table[j * row + u - 1];
+            if (first) {
+                r = t;
+                first = false;
+            } else {
+                ring.multiply(r, r, t);
+            }
+        }
+    }
+    return first ? ring.one() : r;
+}
+
+/*
+ * The product of the g[i]^e[i] by interleaved sliding windows after
+ * E. G. Straus "Addition chains of vectors": each exponent gets its own
+ * window and table of odd powers but the squarings are shared.
+ */
+template <typename Ring>
+typename Ring::value straus_pow(Ring & ring, const std::vector<typename Ring::value> & g,
+                                const std::vector<digit_view> & e) {
+    using value = typename Ring::value;
+    struct window {
+        std::size_t low;
+        digit       index;
+    };
+    std::size_t k = g.size(), bits = 0;
+    std::vector<std::vector<value>> tables(k);
+    // The windows of each exponent from the most significant, each applied
+    // at its lowest bit.
+    std::vector<std::vector<window>> windows(k);
+    for (std::size_t i = 0; i < k; ++i) {
+        std::size_t n = bit_length(e[i]);
+        if (!n) continue;
+        bits = std::max(bits, n);
+        unsigned w = window_size(n);
+        tables[i] = odd_powers(ring, g[i], w);
+        for (std::size_t top = n; top; ) {
+            if (!test_bit(e[i], top - 1)) {
+                --top;
+                continue;
+            }
+            std::size_t low = top > w ? top - w : 0;
+            while (!test_bit(e[i], low)) ++low;
+            windows[i].push_back({ low, extract_bits(e[i], low, top) >> 1 });
+            top = low;
+        }
+    }
+    std::vector<std::size_t> next(k);
+    value r;
+    bool first = true;
+    for (std::size_t bit = bits; bit--; ) {
+        if (!first) ring.square(r, r);
+        for (std::size_t i = 0; i < k; ++i) {
+            if (next[i] == windows[i].size() || windows[i][next[i]].low != bit) continue;
+            const value & t = tables[i][windows[i][next[i]++].index];
+            if (first) {
+                r = t;
+                first = false;
+            } else {
+                ring.multiply(r, r, t);
+            }
+        }
+    }
+    return first ? ring.one() : r;
+}
+
+/*
+ * The product of the g[i]^e[i] by the bucket method of N. Pippenger "On the
+ * evaluation of powers and monomials", in windows of c bits. Within a window
+ * the bases are multiplied into one bucket per digit value d and the
+ * buckets raised to their d by running products, so each base costs one
+ * multiplication per window whatever c is.
+ */
+template <typename Ring>
+typename Ring::value pippenger_pow(Ring & ring, const std::vector<typename Ring::value> & g,
+                                   const std::vector<digit_view> & e, unsigned c) {
+    using value = typename Ring::value;
+    std::size_t k = g.size(), bits = 0;
+    std::vector<std::size_t> lengths(k);
+    for (std::size_t i = 0; i < k; ++i) {
+        lengths[i] = bit_length(e[i]);
+        bits = std::max(bits, lengths[i]);
+    }
+    std::size_t count = (std::size_t(1) << c) - 1;
+    std::vector<value> buckets(count);
+    std::vector<bool> filled(count);
+    value r;
+    bool first = true;
+    for (std::size_t low = (bits + c - 1) / c * c; low; ) {
+        low -= c;
+        if (!first) {
+            for (unsigned j = 0; j < c; ++j) ring.square(r, r);
+        }
+        std::fill(filled.begin(), filled.end(), false);
+        for (std::size_t i = 0; i < k; ++i) {
+            if (lengths[i] <= low) continue;
+            digit d = extract_bits(e[i], low, std::min(low + c, lengths[i]));
+            if (!d) continue;
+            if (filled[d - 1]) {
+                ring.multiply(buckets[d - 1], buckets[d - 1], g[i]);
+            } else {
+                buckets[d - 1] = g[i];
+                filled[d - 1] = true;
+            }
+        }
+        // The product of the buckets to their d is the product of the
+        // running products from the top bucket down.
+        value s, t;
+        bool started = false;
+        for (std::size_t d = count; d; --d) {
+            if (started) {
+                if (filled[d - 1]) ring.multiply(s, s, buckets[d - 1]);
+                ring.multiply(t, t, s);
+            } else if (filled[d - 1]) {
+                s = t = buckets[d - 1];
+                started = true;
+            }
+        }
+        if (!started) continue;
+        if (first) {
+            r = t;
+            first = false;
+        } else {
+            ring.multiply(r, r, t);
+        }
+    }
+    return first ? ring.one() : r;
+}
+
+/*
+ * The product of the g[i]^e[i], by Straus's method or Pippenger's whichever
+ * needs fewer multiplications by estimate. Straus's wins up to some
+ * thousands of bases, depending on the exponent length.
+ */
+template <typename Ring>
+typename Ring::value multi_pow(Ring & ring, const std::vector<typename Ring::value> & g,
+                               const std::vector<digit_view> & e) {
+    std::size_t bits = 0;
+    double straus = 0;
+    for (digit_view x : e) {
+        std::size_t n = bit_length(x);
+        if (!n) continue;
+        bits = std::max(bits, n);
+        unsigned w = window_size(n);
+        straus += double(n) / (w + 1) + (std::size_t(1) << (w - 1));
+    }
+    if (!bits) return ring.one();
+    unsigned best = 0;
+    double pippenger = straus;
+    for (unsigned c = 1; c <= 20 && c <= bits; ++c) {
+        double cost = double((bits + c - 1) / c) * (g.size() + 2.0 * (std::size_t(1) << c));
+        if (cost < pippenger) {
+            best = c;
+            pippenger = cost;
+        }
+    }
+    return best ? pippenger_pow(ring, g, e, best) : straus_pow(ring, g, e);
+}
+
+}
+}
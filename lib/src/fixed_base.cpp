@@ -0,0 +1,131 @@
+#include "fixed_base.hpp"
+#include "barrett.hpp"
+#include "barrett_ring.hpp"
+#include "exponent.hpp"
+#include "montgomery.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace big {
+
+using namespace std;
+
+// The precomputed powers in the representation suiting the modulus.
+class fixed_base::table {
+protected:
+    big_uint            _base;
+    size_t              _exponent_bits;
+    detail::comb_layout _layout;
+
+    table(const big_uint & m, const big_uint & g, size_t exponent_bits, size_t table_bytes)
+        : _base(g % m), _exponent_bits(exponent_bits) {
+        size_t entry_bytes = m.digits().size() * sizeof(digit);
+        _layout = detail::choose_comb(exponent_bits, max<size_t>(table_bytes / entry_bytes, 1));
+    }
+
+    // g^e by the comb when the table covers e.
+    template <typename Ring>
+    typename Ring::value evaluate(Ring & ring, const vector<typename Ring::value> & powers,
+                                  digit_view e) const {
+        if (detail::bit_length(e) <= _layout.bits()) {
+            return detail::comb_pow(ring, powers, _layout, e);
+        }
+        // The first entry is g itself.
+        return detail::sliding_window_pow(ring, powers[0], e);
+    }
+
+public:
+    virtual ~table() = default;
+
+    const big_uint & base() const { return _base; }
+    virtual const big_uint & modulus() const = 0;
+    size_t exponent_bits() const { return _exponent_bits; }
+    size_t size() const { return _layout.entries(); }
+
+    virtual big_uint pow(const big_uint & e) const = 0;
+};
+
+namespace {
+
+// Odd moduli: powers in Montgomery form.
+class montgomery_table final : public fixed_base::table {
+    detail::montgomery   _mont;
+    vector<digit_vector> _powers;
+
+public:
+    montgomery_table(const big_uint & g, const big_uint & m, size_t exponent_bits,
+                     size_t table_bytes)
+        : table(m, g, exponent_bits, table_bytes), _mont(m) {
+        detail::montgomery_ring ring(_mont);
+        digit_vector form(_mont.size());
+        digit_vector scratch(_mont.scratch_size());
+        _mont.to_form(form.data(), _base, scratch.data());
+        _powers = detail::comb_table(ring, form, _layout);
+    }
+
+    const big_uint & modulus() const override { return _mont.modulus(); }
+
+    big_uint pow(const big_uint & e) const override {
+        detail::montgomery_ring ring(_mont);
+        digit_vector r = evaluate(ring, _powers, e.digits());
+        digit_vector scratch(_mont.scratch_size());
+        return _mont.from_form(r.data(), scratch.data());
+    }
+};
+
+// Even moduli and 1.
+class barrett_table final : public fixed_base::table {
+    barrett_context  _context;
+    vector<big_uint> _powers;
+
+public:
+    barrett_table(const big_uint & g, const big_uint & m, size_t exponent_bits,
+                  size_t table_bytes)
+        : table(m, g, exponent_bits, table_bytes), _context(m) {
+        detail::barrett_ring ring(_context);
+        _powers = detail::comb_table(ring, _base, _layout);
+    }
+
+    const big_uint & modulus() const override { return _context.modulus(); }
+
+    big_uint pow(const big_uint & e) const override {
+        detail::barrett_ring ring(_context);
+        return evaluate(ring, _powers, e.digits());
+    }
+};
+
+}
+
+fixed_base::fixed_base(const big_uint & g, const big_uint & m, size_t exponent_bits,
+                       size_t table_bytes) {
+    assert(m != 0u);
+    if (m.digits()[0] & 1 && m != 1u) {
+        _table = make_shared<montgomery_table>(g, m, exponent_bits, table_bytes);
+    } else {
+        _table = make_shared<barrett_table>(g, m, exponent_bits, table_bytes);
+    }
+}
+
+const big_uint & fixed_base::base() const {
+    return _table->base();
+}
+
+const big_uint & fixed_base::modulus() const {
+    return _table->modulus();
+}
+
+size_t fixed_base::exponent_bits() const {
+    return _table->exponent_bits();
+}
+
+size_t fixed_base::table_size() const {
+    return _table->size();
+}
+
+big_uint fixed_base::pow(const big_uint & e) const {
+    return _table->pow(e);
+}
+
+}
@@ -0,0 +1,408 @@
+#include "big_int.hpp"
+#include "big_uint.hpp"
+#include "digit_ops.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+/*
+ * Lehmer's gcd for moderate operands and the subquadratic half-gcd for long
+ * ones, after N. Möller "On Schönhage's algorithm and subquadratic integer
+ * gcd computation" as implemented in GMP. Both reduce a and b by matrices M
+ * of nonnegative entries and determinant 1 such that (a; b) = M (a'; b'),
+ * built from the leading digits alone.
+ */
+namespace big {
+
+using namespace std;
+
+namespace {
+
+/*
+ * Operands of this many digits and more are reduced by half-gcd, which
+ * recurses down to hgcd_threshold digits. Measured on x86-64.
+ */
+const size_t gcd_dc_threshold = detail::digit_bits == 32 ? 360 : 180;
+const size_t hgcd_threshold = detail::digit_bits == 32 ? 120 : 60;
+
+const unsigned half_bits = detail::digit_bits / 2;
+
+struct matrix1 {
+    digit u[2][2];
+};
+
+struct matrix {
+    big_uint u[2][2] = { { big_uint(1), big_uint() }, { big_uint(), big_uint(1) } };
+};
+
+digit high(long_digit x) {
+    return digit(x >> detail::digit_bits);
+}
+
+/*
+ * The matrix of the steps of Euclid's algorithm on the leading two digits a
+ * and b of two numbers which are certain to be steps on the numbers
+ * themselves, as hgcd2 of GMP. Returns false if there isn't even one.
+ */
+bool lehmer_matrix(long_digit a, long_digit b, matrix1 & m) {
+    const long_digit two = long_digit(2) << detail::digit_bits;
+    if (a < two || b < two) return false;
+    long_digit x[2] = { a, b };
+    // Index of the number reduced next.
+    size_t i = a > b ? 0 : 1;
+    x[i] -= x[1 - i];
+    if (x[i] < two) return false;
+    m = { { { 1, 0 }, { 0, 1 } } };
+    // x[i] -= q x[1 - i] multiplies M by a matrix adding q times column i to
+    // the other one.
+    auto update = [&m](size_t i, digit q) {
+        m.u[0][1 - i] += q * m.u[0][i];
+        m.u[1][1 - i] += q * m.u[1][i];
+    };
+    update(i, 1);
+
+    // Double precision until the reduced number fits 1.5 digits.
+    const long_digit split = long_digit(1) << (detail::digit_bits + half_bits);
+    i = high(x[0]) < high(x[1]) ? 1 : 0;
+    for (;; i ^= 1) {
+        long_digit & r = x[i];
+        long_digit d = x[1 - i];
+        if (high(r) == high(d)) return true;
+        if (r < split) break;
+        r -= d;
+        if (r < two) return true;
+        if (high(r) <= high(d)) {
+            update(i, 1);
+            continue;
+        }
+        // One subtraction is done already.
+        digit q = digit(r / d);
+        r %= d;
+        if (r < two) {
+            update(i, q);
+            return true;
+        }
+        update(i, q + 1);
+    }
+
+    // Single precision on the leading 1.5 digits, dropping the last half.
+    const digit small = digit(1) << (half_bits + 1);
+    digit y[2] = { digit(x[0] >> half_bits), digit(x[1] >> half_bits) };
+    for (;; i ^= 1) {
+        digit & r = y[i];
+        digit d = y[1 - i];
+        if (r == d) break;
+        r -= d;
+        if (r < small) break;
+        if (r <= d) {
+            update(i, 1);
+            continue;
+        }
+        digit q = r / d;
+        r %= d;
+        if (r < small) {
+            update(i, q);
+            break;
+        }
+        update(i, q + 1);
+    }
+    return true;
+}
+
+// Digits n - 1 and n - 2 of x after shifting left by s bits.
+long_digit leading(const digit * x, size_t n, unsigned s) {
+    long_digit v = long_digit(x[n - 1]) << detail::digit_bits | x[n - 2];
+    return s ? v << s | x[n - 3] >> (detail::digit_bits - s) : v;
+}
+
+/*
+ * The leading digits of a and b of n digits with those of the longer one
+ * normalized. For n = s + 1 the reduced numbers must keep s + 1 digits, so
+ * they are taken unshifted and have to be large enough.
+ */
+bool leading_pair(const digit * a, const digit * b, size_t n, size_t s,
+                  long_digit & ah, long_digit & bh) {
+    digit mask = a[n - 1] | b[n - 1];
+    unsigned shift = 0;
+    if (n == s + 1) {
+        if (mask < 4) return false;
+    } else {
+        shift = detail::leading_zeros(mask);
+    }
+    ah = leading(a, n, shift);
+    bh = leading(b, n, shift);
+    return true;
+}
+
+/*
+ * (a; b) = M^-1 (a; b) = (u11 a - u01 b; u00 b - u10 a) for a and b of n
+ * digits, t scratch of n digits. Returns the new size.
+ */
+size_t apply_inverse(const matrix1 & m, digit * a, digit * b, size_t n, digit * t) {
+    digit h = detail::mul_1(t, a, n, m.u[1][1]);
+    h -= detail::submul_1(t, b, n, m.u[0][1]);
+    digit k = detail::mul_1(b, b, n, m.u[0][0]);
+    k -= detail::submul_1(b, a, n, m.u[1][0]);
+    assert(!h && !k);
+    copy(t, t + n, a);
+    while (n && !(a[n - 1] | b[n - 1])) --n;
+    return n;
+}
+
+// M = M M1.
+template <typename Matrix>
+void multiply(matrix & m, const Matrix & m1) {
+    for (auto & row : m.u) {
+        big_uint c = row[0] * m1.u[0][0] + row[1] * m1.u[1][0];
+        row[1] = row[0] * m1.u[0][1] + row[1] * m1.u[1][1];
+        row[0] = move(c);
+    }
+}
+
+big_uint to_big_uint(const digit * x, size_t n) {
+    return big_uint(digit_vector(x, x + n));
+}
+
+// Writes x into r and clears r up to n digits.
+void store(digit * r, const big_uint & x, size_t n) {
+    digit_view d = x.digits();
+    assert(d.size() <= n || x == 0u);
+    size_t k = min(d.size(), n);
+    copy(d.begin(), d.begin() + k, r);
+    fill(r + k, r + n, 0);
+}
+
+/*
+ * One subtraction and one division of the larger of a and b by the smaller,
+ * as long as what remains of both exceeds s digits. A quotient q of b by a
+ * adds q times column 1 of M to column 0, one of a by b column 0 to column
+ * 1. Returns the new size, or 0 if no step was possible, in which case for
+ * s = 0 g is the gcd. a and b have room for n + 1 digits.
+ */
+size_t subdiv_step(digit * a, digit * b, size_t n, size_t s, matrix * m, big_uint * g) {
+    size_t an = detail::normalized_size(a, n);
+    size_t bn = detail::normalized_size(b, n);
+    // Whether a holds what was b.
+    size_t swapped = 0;
+    if (an == bn) {
+        int c = detail::compare(a, b, an);
+        if (c == 0) {
+            if (!s) *g = to_big_uint(a, an);
+            return 0;
+        }
+        if (c > 0) {
+            swap(a, b);
+            swapped ^= 1;
+        }
+    } else if (an > bn) {
+        swap(a, b);
+        swap(an, bn);
+        swapped ^= 1;
+    }
+    if (an <= s) {
+        if (!s) *g = to_big_uint(b, bn);
+        return 0;
+    }
+
+    detail::sub(b, b, bn, a, an);
+    bn = detail::normalized_size(b, bn);
+    if (bn <= s) {
+        digit carry = detail::add(b, a, an, b, bn);
+        if (carry) b[an] = carry;
+        return 0;
+    }
+    auto record = [&](const big_uint & q) {
+        if (!m) return;
+        for (auto & row : m->u) row[swapped] += q * row[1 - swapped];
+    };
+    if (an == bn) {
+        int c = detail::compare(a, b, an);
+        if (c == 0) {
+            if (s) {
+                record(big_uint(1));
+            } else {
+                *g = to_big_uint(b, bn);
+            }
+            return 0;
+        }
+        record(big_uint(1));
+        if (c > 0) {
+            swap(a, b);
+            swapped ^= 1;
+        }
+    } else {
+        record(big_uint(1));
+        if (an > bn) {
+            swap(a, b);
+            swap(an, bn);
+            swapped ^= 1;
+        }
+    }
+
+    big_uint divisor = to_big_uint(a, an);
+    big_uint r;
+    big_uint q = big_uint::div(to_big_uint(b, bn), divisor, r);
+    if (r == 0u || r.digits().size() <= s) {
+        if (!s) {
+            *g = move(divisor);
+            return 0;
+        }
+        // The quotient is one too large.
+        r += divisor;
+        --q;
+    }
+    store(b, r, bn);
+    record(q);
+    return max(an, r.digits().size());
+}
+
+/*
+ * One step of half-gcd on a and b of n digits: Lehmer's if possible,
+ * otherwise a division. t is scratch of n digits.
+ */
+size_t hgcd_step(digit * a, digit * b, size_t n, size_t s, matrix & m, digit * t) {
+    long_digit ah, bh;
+    matrix1 m1;
+    if (leading_pair(a, b, n, s, ah, bh) && lehmer_matrix(ah, bh, m1)) {
+        multiply(m, m1);
+        return apply_inverse(m1, a, b, n, t);
+    }
+    return subdiv_step(a, b, n, s, &m, nullptr);
+}
+
+size_t hgcd(digit * a, digit * b, size_t n, matrix & m);
+
+/*
+ * Reduces a and b of n digits by the half-gcd of their digits from p on and
+ * multiplies M by its matrix. Below digit p the numbers are corrected by
+ * the inverse of that matrix. Returns the new size or 0 for no progress.
+ */
+size_t hgcd_reduce(matrix & m, digit * a, digit * b, size_t n, size_t p) {
+    digit_vector ah(n - p + 1), bh(n - p + 1);
+    copy(a + p, a + n, ah.begin());
+    copy(b + p, b + n, bh.begin());
+    matrix r;
+    size_t hn = hgcd(ah.data(), bh.data(), n - p, r);
+    if (!hn) return 0;
+
+    big_uint al = to_big_uint(a, p), bl = to_big_uint(b, p);
+    digit_vector x(p + hn), y(p + hn);
+    copy(ah.begin(), ah.begin() + hn, x.begin() + p);
+    copy(bh.begin(), bh.begin() + hn, y.begin() + p);
+    big_uint a1 = big_uint(move(x)) + r.u[1][1] * al - r.u[0][1] * bl;
+    big_uint b1 = big_uint(move(y)) + r.u[0][0] * bl - r.u[1][0] * al;
+    store(a, a1, n);
+    store(b, b1, n);
+    multiply(m, r);
+    return max(detail::normalized_size(a, n), detail::normalized_size(b, n));
+}
+
+/*
+ * Reduces a and b of n digits, one of them n digits long, while both keep
+ * more than s = n / 2 + 1 digits and multiplies M by the matrix. Returns the
+ * new size or 0 if not even one step was possible. a and b have room for
+ * n + 1 digits.
+ */
+size_t hgcd(digit * a, digit * b, size_t n, matrix & m) {
+    size_t s = n / 2 + 1;
+    if (n <= s) return 0;
+    digit_vector t(n);
+    bool success = false;
+    if (n >= hgcd_threshold) {
+        size_t n2 = 3 * n / 4 + 1;
+        size_t nn = hgcd_reduce(m, a, b, n, n / 2);
+        if (nn) {
+            n = nn;
+            success = true;
+        }
+        while (n > n2) {
+            nn = hgcd_step(a, b, n, s, m, t.data());
+            if (!nn) return success ? n : 0;
+            n = nn;
+            success = true;
+        }
+        if (n > s + 2) {
+            nn = hgcd_reduce(m, a, b, n, 2 * s - n + 1);
+            if (nn) {
+                n = nn;
+                success = true;
+            }
+        }
+    }
+    for (;;) {
+        size_t nn = hgcd_step(a, b, n, s, m, t.data());
+        if (!nn) return success ? n : 0;
+        n = nn;
+        success = true;
+    }
+}
+
+}
+
+big_uint gcd(const big_uint & x, const big_uint & y) {
+    if (x == 0u) return y;
+    if (y == 0u) return x;
+    const big_uint & larger = x < y ? y : x;
+    const big_uint & smaller = x < y ? x : y;
+    size_t n = smaller.digits().size();
+    big_uint reduced;
+    if (larger.digits().size() > n) {
+        reduced = larger % smaller;
+        if (reduced == 0u) return smaller;
+    }
+    digit_view ad = larger.digits().size() > n ? reduced.digits() : larger.digits();
+    digit_view bd = smaller.digits();
+    digit_vector a(n + 1), b(n + 1), t(n);
+    copy(ad.begin(), ad.end(), a.begin());
+    copy(bd.begin(), bd.end(), b.begin());
+
+    big_uint g;
+    while (n >= gcd_dc_threshold) {
+        matrix m;
+        size_t nn = hgcd_reduce(m, a.data(), b.data(), n, 2 * n / 3);
+        if (!nn) {
+            nn = subdiv_step(a.data(), b.data(), n, 0, nullptr, &g);
+            if (!nn) return g;
+        }
+        n = nn;
+    }
+    while (n > 2) {
+        long_digit ah, bh;
+        matrix1 m;
+        if (leading_pair(a.data(), b.data(), n, 0, ah, bh) && lehmer_matrix(ah, bh, m)) {
+            n = apply_inverse(m, a.data(), b.data(), n, t.data());
+        } else {
+            n = subdiv_step(a.data(), b.data(), n, 0, nullptr, &g);
+            if (!n) return g;
+        }
+    }
+    long_digit u = a[0], v = b[0];
+    if (n == 2) {
+        u |= long_digit(a[1]) << detail::digit_bits;
+        v |= long_digit(b[1]) << detail::digit_bits;
+    }
+    while (v) {
+        u %= v;
+        swap(u, v);
+    }
+    digit_vector r(2);
+    r[0] = digit(u);
+    r[1] = high(u);
+    return big_uint(move(r));
+}
+
+big_uint lcm(const big_uint & x, const big_uint & y) {
+    if (x == 0u || y == 0u) return big_uint();
+    return x / gcd(x, y) * y;
+}
+
+big_int gcd(const big_int & x, const big_int & y) {
+    return big_int(big_int::sign_t::PLUS, gcd(x._modulus, y._modulus));
+}
+
+big_int lcm(const big_int & x, const big_int & y) {
+    return big_int(big_int::sign_t::PLUS, lcm(x._modulus, y._modulus));
+}
+
+}
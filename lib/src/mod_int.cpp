@@ -0,0 +1,132 @@
+#include "mod_int.hpp"
+#include "digit_ops.hpp"
+#include "exponent.hpp"
+#include "montgomery.hpp"
+
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+namespace big {
+
+using namespace std;
+
+namespace {
+
+bool is_odd(const big_uint & x) {
+    digit_view d = x.digits();
+    return !d.empty() && d[0] & 1;
+}
+
+// x / 2 mod m for odd m.
+void halve(big_uint & x, const big_uint & m) {
+    if (is_odd(x)) x += m;
+    x /= 2u;
+}
+
+// a^-1 mod m for odd m by the binary extended Euclidean algorithm.
+big_uint invert(big_uint a, const big_uint & m) {
+    big_uint b = m;
+    big_uint x(1), y;
+    // a = x A and b = y A mod m hold throughout.
+    while (a != 1u && b != 1u) {
+        if (a == 0u || b == 0u) throw domain_error("not invertible");
+        while (!is_odd(a)) {
+            a /= 2u;
+            halve(x, m);
+        }
+        while (!is_odd(b)) {
+            b /= 2u;
+            halve(y, m);
+        }
+        if (a >= b) {
+            a -= b;
+            if (x < y) x += m;
+            x -= y;
+        } else {
+            b -= a;
+            if (y < x) y += m;
+            y -= x;
+        }
+    }
+    return a == 1u ? x : y;
+}
+
+// Scratch for the Montgomery operations, kept per thread and grown to the
+// largest modulus seen, so that an operation doesn't allocate.
+digit * scratch(const detail::montgomery & mont) {
+    thread_local digit_vector buffer;
+    if (buffer.size() < mont.scratch_size()) buffer.resize(mont.scratch_size());
+    return buffer.data();
+}
+
+}
+
+mod_int::context::context(const big_uint & m)
+    : _impl(make_shared<const detail::montgomery>(m)) {
+    assert(m > 1u);
+}
+
+const big_uint & mod_int::context::modulus() const {
+    return _impl->modulus();
+}
+
+mod_int::mod_int(const context & c) : _context(c), _value(impl().size()) { }
+
+mod_int::mod_int(const context & c, const big_uint & x) : mod_int(c) {
+    impl().to_form(_value.data(), x, scratch(impl()));
+}
+
+big_uint mod_int::value() const {
+    return impl().from_form(_value.data(), scratch(impl()));
+}
+
+mod_int & mod_int::operator+=(const mod_int & x) {
+    assert(_context._impl == x._context._impl);
+    size_t n = _value.size();
+    const digit * m = modulus().digits().data();
+    digit carry = detail::add_n(_value.data(), _value.data(), x._value.data(), n);
+    if (carry || detail::compare(_value.data(), m, n) >= 0) {
+        detail::sub_n(_value.data(), _value.data(), m, n);
+    }
+    return *this;
+}
+
+mod_int & mod_int::operator-=(const mod_int & x) {
+    assert(_context._impl == x._context._impl);
+    size_t n = _value.size();
+    if (detail::sub_n(_value.data(), _value.data(), x._value.data(), n)) {
+        detail::add_n(_value.data(), _value.data(), modulus().digits().data(), n);
+    }
+    return *this;
+}
+
+mod_int & mod_int::operator*=(const mod_int & x) {
+    assert(_context._impl == x._context._impl);
+    impl().multiply(_value.data(), _value.data(), x._value.data(), scratch(impl()));
+    return *this;
+}
+
+mod_int mod_int::operator-() const {
+    mod_int r(_context);
+    return r -= *this;
+}
+
+mod_int mod_int::square() const {
+    mod_int r(_context);
+    impl().square(r._value.data(), _value.data(), scratch(impl()));
+    return r;
+}
+
+mod_int mod_int::pow(const big_uint & e) const {
+    detail::montgomery_ring ring(impl());
+    mod_int r(_context);
+    r._value = detail::sliding_window_pow(ring, _value, e.digits());
+    return r;
+}
+
+mod_int mod_int::inverse() const {
+    return mod_int(_context, invert(value(), modulus()));
+}
+
+}
@@ -0,0 +1,94 @@
+#include "montgomery.hpp"
+#include "digit_ops.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace big {
+namespace detail {
+
+using namespace std;
+
+digit montgomery_inverse(digit m0) {
+    assert(m0 & 1);
+    // Correct to 3 bits, each Newton step doubles them.
+    digit inverse = m0;
+    for (unsigned bits = 3; bits < digit_bits; bits *= 2) inverse *= 2 - m0 * inverse;
+    return -inverse;
+}
+
+/*
+ * Each step clears the lowest digit of t by adding a multiple of m. Its
+ * carry is kept in the cleared digit and all of them are added at once.
+ */
+void montgomery_reduce(digit * r, digit * t, const digit * m, size_t n, digit minv) {
+    for (size_t i = 0; i < n; ++i) {
+        t[i] = addmul_1(t + i, m, n, t[i] * minv);
+    }
+    digit carry = add_n(t + n, t + n, t, n);
+    // The result is less than 2m.
+    if (carry || compare(t + n, m, n) >= 0) {
+        sub_n(r, t + n, m, n);
+    } else {
+        copy(t + n, t + 2 * n, r);
+    }
+}
+
+montgomery::montgomery(const big_uint & m) : _modulus(m) {
+    digit_view d = m.digits();
+    assert(d[0] & 1);
+    size_t n = d.size();
+    _minv = montgomery_inverse(d[0]);
+    digit_vector power(2 * n + 1);
+    power[2 * n] = 1;
+    _r2 = (big_uint(move(power)) % m).release_digits();
+    _r2.resize(n);
+    _one.resize(n);
+    digit_vector scratch(scratch_size());
+    copy(_r2.begin(), _r2.end(), scratch.begin());
+    fill(scratch.begin() + n, scratch.begin() + 2 * n, 0);
+    montgomery_reduce(_one.data(), scratch.data(), d.data(), n, _minv);
+}
+
+size_t montgomery::scratch_size() const {
+    size_t n = size();
+    return 2 * n + max(multiply_scratch_size(n, n), square_scratch_size(n));
+}
+
+void montgomery::multiply(digit * r, const digit * a, const digit * b,
+                          digit * scratch) const {
+    size_t n = size();
+    detail::multiply(scratch, a, n, b, n, scratch + 2 * n);
+    montgomery_reduce(r, scratch, _modulus.digits().data(), n, _minv);
+}
+
+void montgomery::square(digit * r, const digit * a, digit * scratch) const {
+    size_t n = size();
+    detail::square(scratch, a, n, scratch + 2 * n);
+    montgomery_reduce(r, scratch, _modulus.digits().data(), n, _minv);
+}
+
+void montgomery::to_form(digit * r, const big_uint & x, digit * scratch) const {
+    size_t n = size();
+    digit_vector a;
+    if (x < _modulus) {
+        a = digit_vector(x.digits().begin(), x.digits().end());
+    } else {
+        a = (x % _modulus).release_digits();
+    }
+    a.resize(n);
+    multiply(r, a.data(), _r2.data(), scratch);
+}
+
+big_uint montgomery::from_form(const digit * a, digit * scratch) const {
+    size_t n = size();
+    copy(a, a + n, scratch);
+    fill(scratch + n, scratch + 2 * n, 0);
+    digit_vector r(n);
+    montgomery_reduce(r.data(), scratch, _modulus.digits().data(), n, _minv);
+    return big_uint(move(r));
+}
+
+}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+
+#include "big_uint.hpp"
+#include "digit_vector.hpp"
+
+namespace big {
+namespace detail {
+
+/*
+ * Arithmetic modulo an odd m of n digits in Montgomery form: x stands for
+ * x R mod m, R = B^n, which makes a product a multiplication followed by a
+ * reduction without division. Values are ranges of n digits less than m.
+ * The scratch area of the operations must hold scratch_size() digits.
+ */
+class montgomery {
+    big_uint     _modulus;
+    digit        _minv;
+    // R^2 mod m and R mod m, n digits each.
+    digit_vector _r2;
+    digit_vector _one;
+
+public:
+    explicit montgomery(const big_uint & m);
+
+    const big_uint & modulus() const { return _modulus; }
+    std::size_t size() const { return _one.size(); }
+    std::size_t scratch_size() const;
+
+    // The form of 1.
+    const digit * one() const { return _one.data(); }
+
+    // r = a b R^-1 mod m. r may coincide with a or b.
+    void multiply(digit * r, const digit * a, const digit * b, digit * scratch) const;
+    void square(digit * r, const digit * a, digit * scratch) const;
+
+    // r = x R mod m for any x.
+    void to_form(digit * r, const big_uint & x, digit * scratch) const;
+    // a R^-1 mod m.
+    big_uint from_form(const digit * a, digit * scratch) const;
+};
+
+// Residues in Montgomery form as the ring of sliding_window_pow.
+class montgomery_ring {
+    const montgomery & _mont;
+    digit_vector       _scratch;
+
+public:
+    using value = digit_vector;
+
+    explicit montgomery_ring(const montgomery & mont)
+        : _mont(mont), _scratch(mont.scratch_size()) { }
+
+    value one() const {
+        return digit_vector(_mont.one(), _mont.one() + _mont.size());
+    }
+
+    void multiply(value & r, const value & a, const value & b) {
+        r.resize(_mont.size());
+        _mont.multiply(r.data(), a.data(), b.data(), _scratch.data());
+    }
+
+    void square(value & r, const value & a) {
+        r.resize(_mont.size());
+        _mont.square(r.data(), a.data(), _scratch.data());
+    }
+};
+
+}
+}
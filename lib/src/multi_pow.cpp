@@ -0,0 +1,41 @@
+#include "multi_pow.hpp"
+#include "barrett.hpp"
+#include "barrett_ring.hpp"
+#include "exponent.hpp"
+#include "montgomery.hpp"
+
+#include <cassert>
+#include <vector>
+
+namespace big {
+
+using namespace std;
+
+big_uint multi_pow(const big_uint * g, const big_uint * e, size_t k, const big_uint & m) {
+    assert(m != 0u);
+    vector<digit_view> exponents;
+    exponents.reserve(k);
+    for (size_t i = 0; i < k; ++i) exponents.push_back(e[i].digits());
+    if (m.digits()[0] & 1 && m != 1u) {
+        detail::montgomery mont(m);
+        detail::montgomery_ring ring(mont);
+        digit_vector scratch(mont.scratch_size());
+        vector<digit_vector> bases(k, digit_vector(mont.size()));
+        for (size_t i = 0; i < k; ++i) mont.to_form(bases[i].data(), g[i], scratch.data());
+        digit_vector r = detail::multi_pow(ring, bases, exponents);
+        return mont.from_form(r.data(), scratch.data());
+    }
+    barrett_context context(m);
+    detail::barrett_ring ring(context);
+    vector<big_uint> bases;
+    bases.reserve(k);
+    for (size_t i = 0; i < k; ++i) bases.push_back(g[i] % m);
+    return detail::multi_pow(ring, bases, exponents);
+}
+
+big_uint multi_pow(const vector<big_uint> & g, const vector<big_uint> & e, const big_uint & m) {
+    assert(g.size() == e.size());
+    return multi_pow(g.data(), e.data(), g.size(), m);
+}
+
+}
@@ -0,0 +1,411 @@
+#include "digit_ops.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace big {
+namespace detail {
+
+using namespace std;
+
+// Measured with performance_test on x86-64.
+size_t karatsuba_threshold = 24;
+size_t toom3_threshold     = 200;
+size_t toom4_threshold     = 600;
+
+namespace {
+
+// Adds c to r at offset. c * B^offset is known to fit into rn digits.
+void add_at(digit * r, size_t rn, size_t offset, const digit * c, size_t cn) {
+    cn = normalized_size(c, cn);
+    digit carry = add(r + offset, r + offset, rn - offset, c, cn);
+    assert(carry == 0);
+    (void) carry;
+}
+
+// r -= c * d, where the difference is known to be nonnegative.
+void submul_at(digit * r, size_t rn, const digit * c, size_t cn, digit d) {
+    cn = normalized_size(c, cn);
+    digit borrow = submul_1(r, c, cn, d);
+    borrow = sub_1(r + cn, r + cn, rn - cn, borrow);
+    assert(borrow == 0);
+    (void) borrow;
+}
+
+/*
+ * Given w = W(p) and m = |W(-p)| of n digits, where W(-p) is negative if
+ * negative is set, leaves (W(p) + W(-p)) / 2 in even and (W(p) - W(-p)) / 2
+ * in odd. Both point into the buffers of w and m.
+ */
+void split_even_odd(digit *& even, digit *& odd, digit * w, digit * m,
+                    size_t n, bool negative) {
+    sub_n(w, w, m, n);
+    rshift(w, w, n, 1);
+    add_n(m, m, w, n);
+    even = negative ? w : m;
+    odd  = negative ? m : w;
+}
+
+}
+
+void toom_evaluate(digit * r, const digit * a, size_t an, size_t k,
+                   size_t first, size_t step, digit v) {
+    size_t pieces = (an + k - 1) / k;
+    fill(r, r + k + 1, 0);
+    for (size_t i = first + (pieces - 1 - first) / step * step + step; i > first; ) {
+        i -= step;
+        if (v != 1) mul_1(r, r, k + 1, v);
+        add(r, r, k + 1, a + i * k, min(k, an - i * k));
+    }
+}
+
+bool toom_evaluate_pm(digit * plus, digit * minus, digit * t,
+                      const digit * a, size_t an, size_t k, digit p) {
+    toom_evaluate(t, a, an, k, 0, 2, p * p);
+    toom_evaluate(minus, a, an, k, 1, 2, p * p);
+    if (p != 1) mul_1(minus, minus, k + 1, p);
+    add_n(plus, t, minus, k + 1);
+    return abs_diff(minus, t, k + 1, minus, k + 1);
+}
+
+void toom3_interpolate(digit * r, size_t rn, size_t k,
+                       digit * w1, digit * wm1, bool negative, digit * w2) {
+    size_t n  = 2 * k + 2;
+    size_t hn = rn - 4 * k;
+    digit * c4 = r + 4 * k;
+    digit * e1;
+    digit * o1;
+    split_even_odd(e1, o1, w1, wm1, n, negative);
+    sub(e1, e1, n, r, 2 * k);
+    sub(e1, e1, n, c4, hn);
+    sub(w2, w2, n, r, 2 * k);
+    submul_at(w2, n, e1, n, 4);
+    submul_at(w2, n, c4, hn, 16);
+    rshift(w2, w2, n, 1);
+    sub_n(w2, w2, o1, n);
+    divexact_1(w2, w2, n, 3);
+    sub_n(o1, o1, w2, n);
+
+    fill(r + 2 * k, r + 4 * k, 0);
+    add_at(r, rn, k, o1, n);
+    add_at(r, rn, 2 * k, e1, n);
+    add_at(r, rn, 3 * k, w2, n);
+}
+
+void toom4_interpolate(digit * r, size_t rn, size_t k,
+                       digit * w1, digit * wm1, bool negative1,
+                       digit * w2, digit * wm2, bool negative2, digit * w3) {
+    size_t n  = 2 * k + 2;
+    size_t hn = rn - 6 * k;
+    digit * c6 = r + 6 * k;
+    digit * e1;
+    digit * o1;
+    digit * e2;
+    digit * o2;
+    split_even_odd(e1, o1, w1, wm1, n, negative1);
+    split_even_odd(e2, o2, w2, wm2, n, negative2);
+    rshift(o2, o2, n, 1);
+    sub(e1, e1, n, r, 2 * k);
+    sub(e1, e1, n, c6, hn);
+    sub(e2, e2, n, r, 2 * k);
+    submul_at(e2, n, c6, hn, 64);
+    rshift(e2, e2, n, 2);
+    sub_n(e2, e2, e1, n);
+    divexact_1(e2, e2, n, 3);
+    sub_n(e1, e1, e2, n);
+    sub(w3, w3, n, r, 2 * k);
+    submul_at(w3, n, e1, n, 9);
+    submul_at(w3, n, e2, n, 81);
+    submul_at(w3, n, c6, hn, 729);
+    divexact_1(w3, w3, n, 3);
+    sub_n(w3, w3, o2, n);
+    divexact_1(w3, w3, n, 5);
+    sub_n(o2, o2, o1, n);
+    divexact_1(o2, o2, n, 3);
+    sub_n(w3, w3, o2, n);
+    rshift(w3, w3, n, 3);
+    submul_at(o2, n, w3, n, 5);
+    sub_n(o1, o1, o2, n);
+    sub_n(o1, o1, w3, n);
+
+    fill(r + 2 * k, r + 6 * k, 0);
+    add_at(r, rn, k, o1, n);
+    add_at(r, rn, 2 * k, e1, n);
+    add_at(r, rn, 3 * k, o2, n);
+    add_at(r, rn, 4 * k, e2, n);
+    add_at(r, rn, 5 * k, w3, n);
+}
+
+void school_multiply(digit * r, const digit * a, size_t an,
+                     const digit * b, size_t bn) {
+    if (an < bn) {
+        swap(a, b);
+        swap(an, bn);
+    }
+    r[an] = mul_1(r, a, an, b[0]);
+    for (size_t i = 1; i < bn; ++i) {
+        r[an + i] = addmul_1(r + i, a, an, b[i]);
+    }
+}
+
+/*
+ * a = a0 + a1 * x, b = b0 + b1 * x, where x = B^m, m = ceil(an / 2)
+ * ab = a0b0 + (a0b0 + a1b1 - (a0 - a1)(b0 - b1)) * x + a1b1 * x^2
+ *
+ * Scratch layout: (a0 - a1)(b0 - b1) takes 2m digits, then |a0 - a1| and
+ * |b0 - b1| take m digits each and are later replaced by the middle
+ * coefficient of 2m + 1 digits. Recursive calls use the rest.
+ *
+ * When b isn't longer than m digits the split degenerates to
+ * ab = a0b + a1b * x, where a1b is kept in the scratch area.
+ */
+void karatsuba_multiply(digit * r, const digit * a, size_t an,
+                        const digit * b, size_t bn, digit * scratch) {
+    if (an < bn) {
+        swap(a, b);
+        swap(an, bn);
+    }
+    size_t m = (an + 1) / 2;
+    if (bn <= m) {
+        size_t hn = an - m;
+        multiply(r, a, m, b, bn, scratch);
+        fill(r + m + bn, r + an + bn, 0);
+        multiply(scratch, a + m, hn, b, bn, scratch + hn + bn);
+        digit carry = add_n(r + m, r + m, scratch, hn + bn);
+        assert(carry == 0);
+        (void) carry;
+        return;
+    }
+    size_t ah = an - m;
+    size_t bh = bn - m;
+    digit * t  = scratch;
+    digit * da = scratch + 2 * m;
+    digit * db = scratch + 3 * m;
+    digit * u  = scratch + 2 * m;
+    digit * rest = scratch + 4 * m + 1;
+    bool negative = abs_diff(da, a, m, a + m, ah) != abs_diff(db, b, m, b + m, bh);
+    multiply(t, da, m, db, m, rest);
+    multiply(r, a, m, b, m, rest);
+    multiply(r + 2 * m, a + m, ah, b + m, bh, rest);
+    u[2 * m] = add(u, r, 2 * m, r + 2 * m, ah + bh);
+    if (negative) {
+        add(u, u, 2 * m + 1, t, 2 * m);
+    } else {
+        sub(u, u, 2 * m + 1, t, 2 * m);
+    }
+    size_t rn = an + bn - m;
+    digit carry = add(r + m, r + m, rn, u, min(2 * m + 1, rn));
+    assert(carry == 0);
+    (void) carry;
+}
+
+size_t karatsuba_scratch_size(size_t an, size_t bn) {
+    if (an < bn) swap(an, bn);
+    size_t m = (an + 1) / 2;
+    if (bn <= m) {
+        return max(multiply_scratch_size(m, bn),
+                   an - m + bn + multiply_scratch_size(an - m, bn));
+    }
+    return 4 * m + 1 + max(multiply_scratch_size(m, m),
+                           multiply_scratch_size(an - m, bn - m));
+}
+
+/*
+ * Toom-3 with evaluation points 0, 1, -1, 2 and infinity. The product
+ * polynomial c0 + c1 x + ... + c4 x^4, x = B^k, is interpolated as
+ *   c2 = (W(1) + W(-1)) / 2 - c0 - c4
+ *   c3 = ((W(2) - c0 - 4 c2 - 16 c4) / 2 - (W(1) - W(-1)) / 2) / 3
+ *   c1 = (W(1) - W(-1)) / 2 - c3
+ * All the intermediate values are nonnegative. c0 and c4 are computed right
+ * in place.
+ *
+ * Falls back to Karatsuba when b is too short to have three pieces.
+ */
+void toom3_multiply(digit * r, const digit * a, size_t an,
+                    const digit * b, size_t bn, digit * scratch) {
+    if (an < bn) {
+        swap(a, b);
+        swap(an, bn);
+    }
+    size_t k = (an + 2) / 3;
+    if (bn <= 2 * k) return karatsuba_multiply(r, a, an, b, bn, scratch);
+    size_t n  = 2 * k + 2;
+    digit * w1   = scratch;
+    digit * wm1  = w1 + n;
+    digit * w2   = wm1 + n;
+    digit * ap   = w2 + n;
+    digit * am   = ap + k + 1;
+    digit * at   = am + k + 1;
+    digit * bp   = at + k + 1;
+    digit * bm   = bp + k + 1;
+    digit * bt   = bm + k + 1;
+    digit * rest = bt + k + 1;
+
+    multiply(r, a, k, b, k, rest);
+    multiply(r + 4 * k, a + 2 * k, an - 2 * k, b + 2 * k, bn - 2 * k, rest);
+    bool negative = toom_evaluate_pm(ap, am, at, a, an, k, 1) !=
+                    toom_evaluate_pm(bp, bm, bt, b, bn, k, 1);
+    multiply(w1, ap, k + 1, bp, k + 1, rest);
+    multiply(wm1, am, k + 1, bm, k + 1, rest);
+    toom_evaluate(ap, a, an, k, 0, 1, 2);
+    toom_evaluate(bp, b, bn, k, 0, 1, 2);
+    multiply(w2, ap, k + 1, bp, k + 1, rest);
+
+    toom3_interpolate(r, an + bn, k, w1, wm1, negative, w2);
+}
+
+size_t toom3_scratch_size(size_t an, size_t bn) {
+    if (an < bn) swap(an, bn);
+    size_t k = (an + 2) / 3;
+    if (bn <= 2 * k) return karatsuba_scratch_size(an, bn);
+    return 3 * (2 * k + 2) + 6 * (k + 1) +
+        max(max(multiply_scratch_size(k, k), multiply_scratch_size(k + 1, k + 1)),
+            multiply_scratch_size(an - 2 * k, bn - 2 * k));
+}
+
+/*
+ * Toom-4 with evaluation points 0, 1, -1, 2, -2, 3 and infinity. With
+ * E(p) = (W(p) + W(-p)) / 2 and O(p) = (W(p) - W(-p)) / 2 the coefficients
+ * of c0 + c1 x + ... + c6 x^6 are interpolated as
+ *   c2 + c4      = E(1) - c0 - c6
+ *   c2 + 4 c4    = (E(2) - c0 - 64 c6) / 4
+ *   c1 + c3 + c5 = O(1)
+ *   c1 + 4 c3 + 16 c5 = O(2) / 2
+ *   c1 + 9 c3 + 81 c5 = (W(3) - c0 - 9 c2 - 81 c4 - 729 c6) / 3
+ * The last three equations are solved by taking differences divided by 3
+ * and 5 (c3 + 5 c5 and c3 + 13 c5) and their difference divided by 8. All
+ * the intermediate values are nonnegative.
+ *
+ * Falls back to Toom-3 when b is too short to have four pieces.
+ */
+void toom4_multiply(digit * r, const digit * a, size_t an,
+                    const digit * b, size_t bn, digit * scratch) {
+    if (an < bn) {
+        swap(a, b);
+        swap(an, bn);
+    }
+    size_t k = (an + 3) / 4;
+    if (bn <= 3 * k) return toom3_multiply(r, a, an, b, bn, scratch);
+    size_t n  = 2 * k + 2;
+    digit * w1   = scratch;
+    digit * wm1  = w1 + n;
+    digit * w2   = wm1 + n;
+    digit * wm2  = w2 + n;
+    digit * w3   = wm2 + n;
+    digit * ap   = w3 + n;
+    digit * am   = ap + k + 1;
+    digit * at   = am + k + 1;
+    digit * bp   = at + k + 1;
+    digit * bm   = bp + k + 1;
+    digit * bt   = bm + k + 1;
+    digit * rest = bt + k + 1;
+
+    multiply(r, a, k, b, k, rest);
+    multiply(r + 6 * k, a + 3 * k, an - 3 * k, b + 3 * k, bn - 3 * k, rest);
+    bool negative1 = toom_evaluate_pm(ap, am, at, a, an, k, 1) !=
+                     toom_evaluate_pm(bp, bm, bt, b, bn, k, 1);
+    multiply(w1, ap, k + 1, bp, k + 1, rest);
+    multiply(wm1, am, k + 1, bm, k + 1, rest);
+    bool negative2 = toom_evaluate_pm(ap, am, at, a, an, k, 2) !=
+                     toom_evaluate_pm(bp, bm, bt, b, bn, k, 2);
+    multiply(w2, ap, k + 1, bp, k + 1, rest);
+    multiply(wm2, am, k + 1, bm, k + 1, rest);
+    toom_evaluate(ap, a, an, k, 0, 1, 3);
+    toom_evaluate(bp, b, bn, k, 0, 1, 3);
+    multiply(w3, ap, k + 1, bp, k + 1, rest);
+
+    toom4_interpolate(r, an + bn, k, w1, wm1, negative1, w2, wm2, negative2, w3);
+}
+
+size_t toom4_scratch_size(size_t an, size_t bn) {
+    if (an < bn) swap(an, bn);
+    size_t k = (an + 3) / 4;
+    if (bn <= 3 * k) return toom3_scratch_size(an, bn);
+    return 5 * (2 * k + 2) + 6 * (k + 1) +
+        max(max(multiply_scratch_size(k, k), multiply_scratch_size(k + 1, k + 1)),
+            multiply_scratch_size(an - 3 * k, bn - 3 * k));
+}
+
+/*
+ * a is cut into chunks of about bn digits, so that each chunk times b is a
+ * nearly balanced product, and the products are added up. The top bn digits
+ * of the previous product are already in place, so only that part of the
+ * next one needs an addition. The products go through the scratch area.
+ */
+namespace {
+
+size_t chunk_size(size_t an, size_t bn) {
+    size_t chunks = (an + bn / 2) / bn;
+    return (an + chunks - 1) / chunks;
+}
+
+}
+
+void unbalanced_multiply(digit * r, const digit * a, size_t an,
+                         const digit * b, size_t bn, digit * scratch) {
+    if (an < bn) {
+        swap(a, b);
+        swap(an, bn);
+    }
+    size_t c = chunk_size(an, bn);
+    digit * t    = scratch;
+    digit * rest = scratch + c + bn;
+    multiply(r, a, c, b, bn, rest);
+    for (size_t offset = c; offset < an; offset += c) {
+        size_t n = min(c, an - offset);
+        multiply(t, a + offset, n, b, bn, rest);
+        copy(t + bn, t + n + bn, r + offset + bn);
+        digit carry = add_n(r + offset, r + offset, t, bn);
+        carry = add_1(r + offset + bn, r + offset + bn, n, carry);
+        assert(carry == 0);
+        (void) carry;
+    }
+}
+
+size_t unbalanced_scratch_size(size_t an, size_t bn) {
+    if (an < bn) swap(an, bn);
+    size_t c = chunk_size(an, bn);
+    size_t last = an - (an - 1) / c * c;
+    return c + bn + max(multiply_scratch_size(c, bn),
+                        multiply_scratch_size(last, bn));
+}
+
+// Whether a product is better done chunk by chunk. an >= bn.
+bool is_unbalanced(size_t an, size_t bn) {
+    return an >= 2 * bn && (bn <= ntt_threshold || !ntt_supports(an, bn));
+}
+
+void multiply(digit * r, const digit * a, size_t an,
+              const digit * b, size_t bn, digit * scratch) {
+    if (an < bn) {
+        swap(a, b);
+        swap(an, bn);
+    }
+    if (bn <= karatsuba_threshold) {
+        school_multiply(r, a, an, b, bn);
+    } else if (is_unbalanced(an, bn)) {
+        unbalanced_multiply(r, a, an, b, bn, scratch);
+    } else if (bn <= toom3_threshold) {
+        karatsuba_multiply(r, a, an, b, bn, scratch);
+    } else if (bn <= toom4_threshold) {
+        toom3_multiply(r, a, an, b, bn, scratch);
+    } else if (bn <= ntt_threshold || !ntt_supports(an, bn)) {
+        toom4_multiply(r, a, an, b, bn, scratch);
+    } else {
+        ntt_multiply(r, a, an, b, bn, scratch);
+    }
+}
+
+size_t multiply_scratch_size(size_t an, size_t bn) {
+    if (an < bn) swap(an, bn);
+    if (bn <= karatsuba_threshold) return 0;
+    if (is_unbalanced(an, bn)) return unbalanced_scratch_size(an, bn);
+    if (bn <= toom3_threshold) return karatsuba_scratch_size(an, bn);
+    if (bn <= toom4_threshold) return toom3_scratch_size(an, bn);
+    if (bn <= ntt_threshold || !ntt_supports(an, bn)) return toom4_scratch_size(an, bn);
+    return ntt_scratch_size(an, bn);
+}
+
+}
+}
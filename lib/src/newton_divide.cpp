@@ -0,0 +1,150 @@
+#include "digit_ops.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace big {
+namespace detail {
+
+using namespace std;
+
+// Measured on x86-64. Finding the inverse costs more than a whole division
+// by Burnikel-Ziegler unless the operands are huge.
+size_t newton_threshold = digit_bits == 32 ? 20000 : 60000;
+
+namespace {
+
+// Shorter divisors are inverted by a single school division.
+const size_t invert_base = 8;
+
+size_t invert_size(size_t n) {
+    return n / 2 + 2;
+}
+
+/*
+ * v = B^2n / d to within a few units. The inverse of the top h digits of d,
+ * correct to about h digits, is refined by one Newton step
+ *
+ *     x' = 2 x - d x^2 / B^2n,
+ *
+ * which doubles the number of correct digits. Since x' never exceeds
+ * B^2n / d by more than the truncation of d x^2, the error doesn't grow
+ * from level to level.
+ */
+void invert_approx(digit * v, const digit * d, size_t n, digit * scratch) {
+    if (n <= invert_base) {
+        digit * u = scratch;
+        fill(u, u + 2 * n, 0);
+        u[2 * n] = 1;
+        if (n == 1) {
+            digit * q = u + 2 * n + 1;
+            divrem_1(q, u, 3, d[0]);
+            copy(q, q + 2, v);
+        } else {
+            digit qh = school_divide(v, u, 2 * n + 1, d, n);
+            assert(qh == 0);
+            (void) qh;
+        }
+        return;
+    }
+    size_t h = invert_size(n);
+    size_t l = n - h;
+    invert_approx(v + l, d + l, h, scratch);
+    digit * s = scratch;
+    digit * t = s + 2 * h + 2;
+    digit * rest = t + n + 2 * h + 2;
+    square(s, v + l, h + 1, rest);
+    multiply(t, s, 2 * h + 2, d, n, rest);
+    fill(v, v + l, 0);
+    digit carry = lshift(v + l, v + l, h + 1, 1);
+    assert(carry == 0 && t[n + 2 * h + 1] == 0);
+    digit borrow = sub_n(v, v, t + 2 * h, n + 1);
+    assert(borrow == 0);
+    (void) carry;
+    (void) borrow;
+}
+
+size_t invert_approx_scratch_size(size_t n) {
+    if (n <= invert_base) return 2 * n + 4;
+    size_t h = invert_size(n);
+    size_t step = 2 * h + 2 + n + 2 * h + 2 +
+        max(square_scratch_size(h + 1), multiply_scratch_size(2 * h + 2, n));
+    return max(invert_approx_scratch_size(h), step);
+}
+
+}
+
+/*
+ * The approximation is fixed by the remainder B^2n - d v, computed modulo
+ * B^(2n + 1) where it can only be slightly negative.
+ */
+void invert(digit * v, const digit * d, size_t n, digit * scratch) {
+    assert(d[n - 1] >> (digit_bits - 1));
+    invert_approx(v, d, n, scratch);
+    size_t rn = 2 * n + 1;
+    digit * r = scratch;
+    multiply(r, v, n + 1, d, n, r + rn);
+    for (size_t i = 0; i < rn; ++i) r[i] = ~r[i];
+    add_1(r, r, rn, 1);
+    r[2 * n] += 1;
+    while (r[2 * n] >> (digit_bits - 1)) {
+        sub_1(v, v, n + 1, 1);
+        add(r, r, rn, d, n);
+    }
+    while (compare(r, rn, d, n) >= 0) {
+        add_1(v, v, n + 1, 1);
+        sub(r, r, rn, d, n);
+    }
+}
+
+size_t invert_scratch_size(size_t n) {
+    return max(invert_approx_scratch_size(n),
+               2 * n + 1 + multiply_scratch_size(n + 1, n));
+}
+
+/*
+ * Blocks of k <= dn quotient digits are estimated from the top k digits of
+ * the running remainder and the top k + 1 digits of v. The estimate is at
+ * most 4 too small, and never too large, so the block is fixed by
+ * subtracting d a few times.
+ */
+digit newton_divide(digit * q, digit * a, size_t an, const digit * d, size_t dn,
+                    const digit * v, digit * scratch) {
+    size_t qn = an - dn;
+    digit qh = compare(a + qn, d, dn) >= 0;
+    if (qh) sub_n(a + qn, a + qn, d, dn);
+    digit * t = scratch;
+    digit * p = t + 2 * dn + 1;
+    digit * rest = p + 2 * dn;
+    for (size_t j = qn; j > 0; ) {
+        size_t k = j % dn ? j % dn : dn;
+        j -= k;
+        digit * u = a + j;
+        multiply(t, u + dn, k, v + dn - k, k + 1, rest);
+        assert(t[2 * k] == 0);
+        copy(t + k, t + 2 * k, q + j);
+        multiply(p, q + j, k, d, dn, rest);
+        digit borrow = sub_n(u, u, p, dn + k);
+        assert(borrow == 0);
+        (void) borrow;
+        while (compare(u, dn + 1, d, dn) >= 0) {
+            sub(u, u, dn + 1, d, dn);
+            add_1(q + j, q + j, k, 1);
+        }
+    }
+    return qh;
+}
+
+size_t newton_divide_scratch_size(size_t an, size_t dn) {
+    size_t k = (an - dn) % dn;
+    size_t size = max(multiply_scratch_size(dn, dn + 1),
+                      multiply_scratch_size(dn, dn));
+    if (k) {
+        size = max(size, max(multiply_scratch_size(k, k + 1),
+                             multiply_scratch_size(k, dn)));
+    }
+    return 4 * dn + 1 + size;
+}
+
+}
+}
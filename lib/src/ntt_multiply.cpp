@@ -0,0 +1,186 @@
+#include "digit_ops.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+/*
+ * Multiplication by number-theoretic transforms modulo three primes of the
+ * form c * 2^k + 1. Digits are cut into 32-bit coefficients, the cyclic
+ * convolution is computed modulo each prime and the exact coefficients
+ * (less than min(an, bn) * 2^64 < p0 * p1 * p2) are recovered by the
+ * Chinese remainder theorem while the carries are propagated.
+ */
+namespace big {
+namespace detail {
+
+using namespace std;
+
+// Wide digits are cut into two coefficients, so the crossover comes later.
+size_t ntt_threshold = digit_bits == 32 ? 4000 : 16000;
+
+namespace {
+
+const uint32_t p0 = 167772161;   // 5 * 2^25 + 1
+const uint32_t p1 = 469762049;   // 7 * 2^26 + 1
+const uint32_t p2 = 998244353;   // 119 * 2^23 + 1
+
+// 3 is a primitive root modulo each of the primes.
+const uint64_t generator = 3;
+
+// The longest transform all three primes support.
+const size_t max_transform_size = size_t(1) << 23;
+
+// 32-bit coefficients per digit.
+const size_t pieces = digit_bits / 32;
+
+uint64_t pow_mod(uint64_t b, uint64_t e, uint64_t p) {
+    uint64_t r = 1;
+    for (; e; e >>= 1) {
+        if (e & 1) r = r * b % p;
+        b = b * b % p;
+    }
+    return r;
+}
+
+uint64_t piece(const digit * a, size_t i) {
+    return a[i / pieces] >> (32 * (i % pieces)) & 0xffffffff;
+}
+
+size_t transform_size(size_t an, size_t bn) {
+    size_t n = 1;
+    while (n < (an + bn) * pieces - 1) n *= 2;
+    return n;
+}
+
+/*
+ * The residues modulo P live in digits. tw[h + j] is the j-th power of the
+ * primitive 2h-th root of unity, 0 < h < n.
+ */
+template <uint32_t P>
+void make_twiddles(digit * tw, size_t n) {
+    for (size_t h = 1; h < n; h *= 2) {
+        uint64_t w = pow_mod(generator, (P - 1) / (2 * h), P);
+        tw[h] = 1;
+        for (size_t j = 1; j < h; ++j) tw[h + j] = uint64_t(tw[h + j - 1]) * w % P;
+    }
+}
+
+// Decimation in frequency. Natural order in, bit reversed order out.
+template <uint32_t P>
+void forward(digit * a, size_t n, const digit * tw) {
+    for (size_t h = n / 2; h; h /= 2) {
+        const digit * w = tw + h;
+        for (size_t i = 0; i < n; i += 2 * h) {
+            for (size_t j = 0; j < h; ++j) {
+                uint64_t u = a[i + j];
+                uint64_t v = a[i + j + h];
+                uint64_t s = u + v;
+                a[i + j] = s >= P ? s - P : s;
+                a[i + j + h] = (u + P - v) * w[j] % P;
+            }
+        }
+    }
+}
+
+/*
+ * Decimation in time with the inverse roots, without the division by n.
+ * Bit reversed order in, natural order out. The inverse of w^j is
+ * -w^(h - j).
+ */
+template <uint32_t P>
+void inverse(digit * a, size_t n, const digit * tw) {
+    for (size_t h = 1; h < n; h *= 2) {
+        const digit * w = tw + h;
+        for (size_t i = 0; i < n; i += 2 * h) {
+            uint64_t u = a[i];
+            uint64_t v = a[i + h];
+            a[i] = u + v >= P ? u + v - P : u + v;
+            a[i + h] = u >= v ? u - v : u + P - v;
+            for (size_t j = 1; j < h; ++j) {
+                u = a[i + j];
+                v = uint64_t(a[i + j + h]) * w[h - j] % P;
+                a[i + j] = u >= v ? u - v : u + P - v;
+                a[i + j + h] = u + v >= P ? u + v - P : u + v;
+            }
+        }
+    }
+}
+
+template <uint32_t P>
+void load(digit * f, size_t n, const digit * a, size_t an) {
+    size_t ap = an * pieces;
+    for (size_t i = 0; i < ap; ++i) f[i] = piece(a, i) % P;
+    fill(f + ap, f + n, 0);
+}
+
+/*
+ * fa = a * b modulo P and x^n - 1, where n is the transform size. fb and tw
+ * are n digits each. A square takes a single forward transform.
+ */
+template <uint32_t P>
+void convolve(digit * fa, digit * fb, digit * tw, size_t n,
+              const digit * a, size_t an, const digit * b, size_t bn) {
+    make_twiddles<P>(tw, n);
+    load<P>(fa, n, a, an);
+    forward<P>(fa, n, tw);
+    if (a == b && an == bn) {
+        fb = fa;
+    } else {
+        load<P>(fb, n, b, bn);
+        forward<P>(fb, n, tw);
+    }
+    uint64_t scale = pow_mod(n, P - 2, P);
+    for (size_t i = 0; i < n; ++i) fa[i] = uint64_t(fa[i]) * fb[i] % P * scale % P;
+    inverse<P>(fa, n, tw);
+}
+
+}
+
+bool ntt_supports(size_t an, size_t bn) {
+    return (an + bn) * pieces - 1 <= max_transform_size;
+}
+
+void ntt_multiply(digit * r, const digit * a, size_t an,
+                  const digit * b, size_t bn, digit * scratch) {
+    size_t n = transform_size(an, bn);
+    digit * r0 = scratch;
+    digit * r1 = r0 + n;
+    digit * r2 = r1 + n;
+    digit * fb = r2 + n;
+    digit * tw = fb + n;
+    convolve<p0>(r0, fb, tw, n, a, an, b, bn);
+    convolve<p1>(r1, fb, tw, n, a, an, b, bn);
+    convolve<p2>(r2, fb, tw, n, a, an, b, bn);
+
+    // Garner's algorithm: x = x0 + p0 t1 + p0 p1 t2.
+    const uint64_t p01 = uint64_t(p0) * p1;
+    const uint64_t p01_lo = p01 & 0xffffffff;
+    const uint64_t p01_hi = p01 >> 32;
+    const uint64_t inv_p0 = pow_mod(p0, p1 - 2, p1);
+    const uint64_t inv_p01 = pow_mod(p01 % p2, p2 - 2, p2);
+    size_t rn = an + bn;
+    fill(r, r + rn, 0);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < rn * pieces; ++i) {
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        if (i < n) {
+            uint64_t x0 = r0[i];
+            uint64_t t1 = (uint64_t(r1[i]) + p1 - x0) * inv_p0 % p1;
+            uint64_t x01 = x0 + p0 * t1;
+            uint64_t t2 = (uint64_t(r2[i]) + p2 - x01 % p2) * inv_p01 % p2;
+            lo = x01 + p01_lo * t2;
+            hi = p01_hi * t2;
+        }
+        uint64_t low = (lo & 0xffffffff) + (carry & 0xffffffff);
+        r[i / pieces] |= digit(low & 0xffffffff) << (32 * (i % pieces));
+        carry = (low >> 32) + (lo >> 32) + (carry >> 32) + hi;
+    }
+}
+
+size_t ntt_scratch_size(size_t an, size_t bn) {
+    return 5 * transform_size(an, bn);
+}
+
+}
+}
@@ -0,0 +1,53 @@
+#include "big_uint.hpp"
+#include "digit_ops.hpp"
+#include "exponent.hpp"
+#include "montgomery.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace big {
+
+using namespace std;
+
+namespace {
+
+// Plain residues for even moduli, reduced by division.
+class division_ring {
+    const big_uint & _modulus;
+
+public:
+    using value = big_uint;
+
+    explicit division_ring(const big_uint & modulus) : _modulus(modulus) { }
+
+    value one() const { return big_uint(1) % _modulus; }
+
+    void multiply(value & r, const value & a, const value & b) {
+        r = a * b % _modulus;
+    }
+
+    void square(value & r, const value & a) {
+        r = a.square() % _modulus;
+    }
+};
+
+}
+
+big_uint big_uint::pow_mod(const big_uint & e, const big_uint & mod) const {
+    assert(mod != 0u);
+    if (mod == 1u) return big_uint();
+    if (!(mod._digits[0] & 1)) {
+        division_ring ring(mod);
+        return detail::sliding_window_pow(ring, *this % mod, e.digits());
+    }
+    detail::montgomery mont(mod);
+    detail::montgomery_ring ring(mont);
+    digit_vector g(mont.size());
+    digit_vector scratch(mont.scratch_size());
+    mont.to_form(g.data(), *this, scratch.data());
+    digit_vector r = detail::sliding_window_pow(ring, g, e.digits());
+    return mont.from_form(r.data(), scratch.data());
+}
+
+}
@@ -0,0 +1,333 @@
+#include "radix.hpp"
+#include "digit_ops.hpp"
+#include "reciprocal.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/*
+ * Conversion works on chunks of characters whose value fits into a digit.
+ * Short numbers are converted a chunk per pass over the digits. Longer ones
+ * are split by a power (base^chunk)^(2^k) of about half their length and
+ * both parts are converted recursively, which brings the cost down to that
+ * of division. Bases that are powers of two need no arithmetic at all, the
+ * bits of the digits are only regrouped into characters.
+ */
+namespace big {
+namespace detail {
+
+using namespace std;
+
+// Measured on x86-64 in base 10.
+size_t radix_threshold = 30;
+
+namespace {
+
+// Shorter powers are divided by without a precomputed reciprocal.
+const size_t reciprocal_threshold = digit_bits == 32 ? 1000 : 500;
+
+const char symbols[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// Writes the count lowest digits of c in base B before p.
+template <unsigned B>
+char * write_digits(char * p, digit c, unsigned count) {
+    for (unsigned i = 0; i < count; ++i) {
+        *--p = symbols[c % B];
+        c /= B;
+    }
+    return p;
+}
+
+// Base 10 gets division by a constant.
+char * write_digits(char * p, digit c, unsigned count, unsigned base) {
+    if (base == 10) return write_digits<10>(p, c, count);
+    for (unsigned i = 0; i < count; ++i) {
+        *--p = symbols[c % base];
+        c /= base;
+    }
+    return p;
+}
+
+void write_school(char * first, char * last, digit_view x, const radix & r) {
+    digit_vector a(x.begin(), x.end());
+    const divisor_1 power(r.power);
+    size_t n = normalized_size(a.data(), a.size());
+    char * p = last;
+    while (n) {
+        digit c = divrem_1(a.data(), a.data(), n, power);
+        if (!a[n - 1]) --n;
+        unsigned count = min<size_t>(r.chunk, p - first);
+        p = write_digits(p, c, count, r.base);
+        assert(count == r.chunk || n == 0);
+    }
+    fill(first, p, '0');
+}
+
+big_uint read_school(const char * first, const char * last, const radix & r) {
+    size_t len = last - first;
+    digit_vector a(len / r.chunk + 1);
+    size_t n = 0;
+    const char * p = first;
+    for (size_t c = len % r.chunk ? len % r.chunk : r.chunk; p != last; c = r.chunk) {
+        digit scale = 1;
+        digit v = 0;
+        for (const char * e = p + c; p != e; ++p) {
+            scale *= r.base;
+            v = v * r.base + char_value(*p, r.base);
+        }
+        digit carry = mul_1(a.data(), a.data(), n, scale);
+        carry += add_1(a.data(), a.data(), n, v);
+        if (carry) a[n++] = carry;
+    }
+    return big_uint(move(a));
+}
+
+/*
+ * Base 2^s, s bits per character, least significant character last. The
+ * skip lowest characters of x are left out.
+ */
+void write_bits(char * first, char * last, digit_view x, unsigned s, size_t skip = 0) {
+    const digit mask = (digit(1) << s) - 1;
+    const size_t end = x.size() * digit_bits;
+    char * p = last;
+    for (size_t bit = skip * s; p != first && bit < end; bit += s) {
+        size_t i = bit / digit_bits;
+        unsigned k = bit % digit_bits;
+        digit c = x[i] >> k;
+        if (k + s > digit_bits && i + 1 < x.size()) c |= x[i + 1] << (digit_bits - k);
+        *--p = symbols[c & mask];
+    }
+    fill(first, p, '0');
+}
+
+big_uint read_bits(const char * first, const char * last, unsigned base, unsigned s) {
+    digit_vector a((last - first) * s / digit_bits + 1);
+    size_t bit = 0;
+    for (const char * p = last; p != first; bit += s) {
+        digit c = char_value(*--p, base);
+        size_t i = bit / digit_bits;
+        unsigned k = bit % digit_bits;
+        a[i] |= c << k;
+        if (k + s > digit_bits) a[i + 1] |= c >> (digit_bits - k);
+    }
+    return big_uint(move(a));
+}
+
+// s such that base = 2^s, or 0 if there is none.
+unsigned bits_per_char(unsigned base) {
+    return base & (base - 1) ? 0 : __builtin_ctz(base);
+}
+
+struct power_entry {
+    big_uint               power;
+    unique_ptr<reciprocal> inverse;
+};
+
+/*
+ * (base^chunk)^(2^k). The powers are computed on first use and kept for
+ * the calling thread.
+ */
+power_entry & power_table(const radix & r, size_t k) {
+    thread_local deque<power_entry> tables[37];
+    deque<power_entry> & powers = tables[r.base];
+    if (powers.empty()) powers.push_back({ big_uint(r.power), nullptr });
+    while (powers.size() <= k) powers.push_back({ powers.back().power.square(), nullptr });
+    return powers[k];
+}
+
+// k such that the k-th power splits width characters most evenly.
+size_t split_power(size_t width, const radix & r) {
+    size_t k = 0;
+    while (r.chunk << (k + 1) <= width / 2) ++k;
+    size_t below = width / 2 - (r.chunk << k);
+    size_t above = (r.chunk << (k + 1)) - width / 2;
+    return above < below && r.chunk << (k + 1) < width ? k + 1 : k;
+}
+
+/*
+ * q = x / power, r = x % power for the k-th power. Long powers divide many
+ * parts of a number, so they keep their reciprocal.
+ */
+big_uint divide_by_power(const big_uint & x, const radix & r, size_t k,
+                         big_uint & rem) {
+    power_entry & e = power_table(r, k);
+    if (e.power.digits().size() < reciprocal_threshold) {
+        return big_uint::div(x, e.power, rem);
+    }
+    if (!e.inverse) e.inverse.reset(new reciprocal(e.power));
+    return e.inverse->div(x, rem);
+}
+
+void write_radix(char * first, char * last, const big_uint & x, const radix & r) {
+    size_t width = last - first;
+    if (x.digits().size() < max<size_t>(radix_threshold, 2) || width < 2 * r.chunk) {
+        return write_school(first, last, x.digits(), r);
+    }
+    size_t k = split_power(width, r);
+    size_t low = r.chunk << k;
+    big_uint rem;
+    big_uint q = divide_by_power(x, r, k, rem);
+    write_radix(last - low, last, rem, r);
+    write_radix(first, last - low, q, r);
+}
+
+/*
+ * Collects characters into chunks, dropping the leading zeros of the
+ * number.
+ */
+class chunk_sink {
+    vector<char>                       _buffer;
+    // Text of the leaves of the conversion before the leading zeros go.
+    vector<char>                       _leaf;
+    size_t                             _size;
+    bool                               _leading;
+    const function<void(char *, size_t)> & _emit;
+
+    void flush() {
+        if (_size) _emit(_buffer.data(), _size);
+        _size = 0;
+    }
+
+public:
+    chunk_sink(size_t chunk, const function<void(char *, size_t)> & emit)
+        : _buffer(max<size_t>(chunk, 1)), _size(0), _leading(true), _emit(emit) { }
+
+    char * leaf(size_t n) {
+        if (_leaf.size() < n) _leaf.resize(n);
+        return _leaf.data();
+    }
+
+    void put(const char * first, const char * last) {
+        if (_leading) {
+            first = find_if(first, last, [](char c) { return c != '0'; });
+            _leading = first == last;
+        }
+        while (first != last) {
+            size_t n = min<size_t>(last - first, _buffer.size() - _size);
+            copy(first, first + n, _buffer.data() + _size);
+            first += n;
+            if ((_size += n) == _buffer.size()) flush();
+        }
+    }
+
+    void put_zeros(size_t n) {
+        if (_leading) return;
+        char zeros[64];
+        fill(begin(zeros), end(zeros), '0');
+        for (size_t m; n; n -= m) {
+            m = min(n, sizeof(zeros));
+            put(zeros, zeros + m);
+        }
+    }
+
+    // Zero is written as a single character.
+    void finish() {
+        if (_leading) _buffer[_size++] = '0';
+        flush();
+    }
+};
+
+// write_radix for characters in order, the high part before the low one.
+void stream_radix(chunk_sink & out, const big_uint & x, size_t width, const radix & r) {
+    if (x.digits().size() < max<size_t>(radix_threshold, 2) || width < 2 * r.chunk) {
+        size_t length = min(width, radix_size(x.digits().size(), r.base));
+        out.put_zeros(width - length);
+        char * buffer = out.leaf(length);
+        write_school(buffer, buffer + length, x.digits(), r);
+        out.put(buffer, buffer + length);
+        return;
+    }
+    size_t k = split_power(width, r);
+    size_t low = r.chunk << k;
+    big_uint rem;
+    big_uint q = divide_by_power(x, r, k, rem);
+    stream_radix(out, q, width - low, r);
+    q = big_uint();
+    stream_radix(out, rem, low, r);
+}
+
+big_uint read_radix(const char * first, const char * last, const radix & r) {
+    size_t len = last - first;
+    if (len < max<size_t>(radix_threshold, 2) * r.chunk) return read_school(first, last, r);
+    size_t k = split_power(len, r);
+    size_t low = r.chunk << k;
+    big_uint x = read_radix(first, last - low, r) * power_table(r, k).power;
+    return x += read_radix(last - low, last, r);
+}
+
+}
+
+radix::radix(unsigned b) : base(b), chunk(0), power(1) {
+    assert(b >= 2 && b <= 36);
+    while (power <= ~digit(0) / base) {
+        power *= base;
+        ++chunk;
+    }
+}
+
+size_t radix_size(size_t n, unsigned base) {
+    // The margin covers the rounding of the logarithms.
+    double bits = static_cast<double>(n) * digit_bits;
+    return static_cast<size_t>(bits / log2(base) * (1 + 1e-12)) + 1;
+}
+
+bool at_least_power(const big_uint & x, unsigned base, size_t e) {
+    digit_view d = x.digits();
+    size_t n = d.size();
+    double top = d[n - 1];
+    if (n > 1) top = ldexp(top, digit_bits) + d[n - 2];
+    double lx = log2(top) + (n > 1 ? (n - 2) * double(digit_bits) : 0);
+    double lp = e * log2(base);
+    // Bounds the rounding of both logarithms and the dropped digits.
+    double margin = 1e-12 * (lx + lp) + 1e-9;
+    if (x == 0u || lx < lp - margin) return false;
+    if (lx > lp + margin) return true;
+    radix r(base);
+    big_uint power(1);
+    for (size_t i = 0; i < e % r.chunk; ++i) power *= base;
+    for (size_t q = e / r.chunk, k = 0; q; q >>= 1, ++k) {
+        if (q & 1) power *= power_table(r, k).power;
+    }
+    return x >= power;
+}
+
+void write_radix(char * first, char * last, const big_uint & x, unsigned base) {
+    if (unsigned s = bits_per_char(base)) return write_bits(first, last, x.digits(), s);
+    write_radix(first, last, x, radix(base));
+}
+
+void stream_radix(const big_uint & x, unsigned base, size_t chunk,
+                  const function<void(char *, size_t)> & emit) {
+    size_t width = radix_size(x.digits().size(), base);
+    chunk_sink out(min(chunk, width), emit);
+    if (unsigned s = bits_per_char(base)) {
+        vector<char> buffer(min(width, max<size_t>(chunk, 1)));
+        for (size_t high = width; high; ) {
+            size_t n = min(high, buffer.size());
+            high -= n;
+            write_bits(buffer.data(), buffer.data() + n, x.digits(), s, high);
+            out.put(buffer.data(), buffer.data() + n);
+        }
+    } else {
+        stream_radix(out, x, width, radix(base));
+    }
+    out.finish();
+}
+
+const char * scan_radix(const char * first, const char * last, unsigned base) {
+    return find_if(first, last, [base](char c) { return char_value(c, base) == base; });
+}
+
+big_uint read_radix(const char * first, const char * last, unsigned base) {
+    first = find_if(first, last, [](char c) { return c != '0'; });
+    if (unsigned s = bits_per_char(base)) return read_bits(first, last, base, s);
+    return read_radix(first, last, radix(base));
+}
+
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "big_uint.hpp"
+
+namespace big {
+namespace detail {
+
+// Tuning parameter in digits. Accessed through big_uint::set_radix_threshold.
+extern std::size_t radix_threshold;
+
+/*
+ * A base from 2 to 36. Conversion works on chunks of chunk characters, the
+ * most whose value fits into a digit, power = base^chunk.
+ */
+struct radix {
+    unsigned base;
+    unsigned chunk;
+    digit    power;
+
+    explicit radix(unsigned base);
+};
+
+// Upper bound of the length of a number of n digits in the base.
+std::size_t radix_size(std::size_t n, unsigned base);
+
+/*
+ * Writes x < base^(last - first) to [first, last) with leading zeros. Digits
+ * above 9 are lower case letters.
+ */
+void write_radix(char * first, char * last, const big_uint & x, unsigned base);
+
+/*
+ * Whether x >= base^e. The logarithms decide unless x is very close to the
+ * power, which is then built from the cached powers of the conversion.
+ */
+bool at_least_power(const big_uint & x, unsigned base, std::size_t e);
+
+/*
+ * Writes x without leading zeros, most significant character first, by
+ * calls of emit with at most chunk characters each. Besides the chunk it
+ * holds O(n) digits, never the whole text.
+ */
+void stream_radix(const big_uint & x, unsigned base, std::size_t chunk,
+                  const std::function<void(char *, std::size_t)> & emit);
+
+// Value of the character c as a digit of the base, or base if it isn't one.
+inline unsigned char_value(char c, unsigned base) {
+    unsigned v = c >= '0' && c <= '9' ? c - '0'
+               : c >= 'a' && c <= 'z' ? c - 'a' + 10
+               : c >= 'A' && c <= 'Z' ? c - 'A' + 10
+               : base;
+    return v < base ? v : base;
+}
+
+// End of the run of digits of the base at the beginning of [first, last).
+const char * scan_radix(const char * first, const char * last, unsigned base);
+
+// The number written in [first, last), which holds only digits of the base.
+big_uint read_radix(const char * first, const char * last, unsigned base);
+
+}
+}
@@ -0,0 +1,66 @@
+#include "reciprocal.hpp"
+#include "digit_ops.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace big {
+
+using namespace std;
+
+reciprocal::reciprocal(const big_uint & divisor) : _divisor(divisor) {
+    assert(divisor != 0u);
+    digit_view d = divisor.digits();
+    size_t n = d.size();
+    _shift = detail::leading_zeros(d[n - 1]);
+    _normalized.resize(n);
+    if (_shift) {
+        detail::lshift(_normalized.data(), d.data(), n, _shift);
+    } else {
+        copy(d.begin(), d.end(), _normalized.begin());
+    }
+    _inverse.resize(n + 1);
+    digit_vector scratch(detail::invert_scratch_size(n));
+    detail::invert(_inverse.data(), _normalized.data(), n, scratch.data());
+}
+
+big_uint reciprocal::div(const big_uint & dividend, big_uint & reminder) const {
+    if (dividend < _divisor) {
+        reminder = dividend;
+        return { };
+    }
+    digit_view a = dividend.digits();
+    size_t an = a.size();
+    size_t dn = _normalized.size();
+    digit_vector na(an + 1);
+    if (_shift) {
+        na[an] = detail::lshift(na.data(), a.data(), an, _shift);
+    } else {
+        copy(a.begin(), a.end(), na.begin());
+    }
+    digit_vector quot(an + 1 - dn);
+    digit_vector scratch(detail::newton_divide_scratch_size(an + 1, dn));
+    digit qh = detail::newton_divide(quot.data(), na.data(), an + 1,
+                                     _normalized.data(), dn,
+                                     _inverse.data(), scratch.data());
+    assert(qh == 0);
+    (void) qh;
+    na.resize(dn);
+    if (_shift) detail::rshift(na.data(), na.data(), dn, _shift);
+    reminder = big_uint(move(na));
+    return big_uint(move(quot));
+}
+
+big_uint reciprocal::div(const big_uint & dividend) const {
+    big_uint reminder;
+    return div(dividend, reminder);
+}
+
+big_uint reciprocal::mod(const big_uint & dividend) const {
+    big_uint reminder;
+    div(dividend, reminder);
+    return reminder;
+}
+
+}
@@ -0,0 +1,159 @@
+#include "digit_ops.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace big {
+namespace detail {
+
+using namespace std;
+
+// Measured with performance_test on x86-64. Higher tiers share the
+// multiplication thresholds.
+size_t karatsuba_square_threshold = 48;
+
+/*
+ * The cross products a_i a_j, i < j, are accumulated once and doubled, then
+ * the squares of the digits are added on the diagonal.
+ */
+void school_square(digit * r, const digit * a, size_t n) {
+    r[0] = 0;
+    r[n] = mul_1(r + 1, a + 1, n - 1, a[0]);
+    for (size_t i = 1; i + 1 < n; ++i) {
+        r[n + i] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+    }
+    r[2 * n - 1] = lshift(r + 1, r + 1, 2 * n - 2, 1);
+    digit carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        long_digit sq = static_cast<long_digit>(a[i]) * a[i];
+        long_digit t = static_cast<long_digit>(r[2 * i]) + static_cast<digit>(sq) + carry;
+        r[2 * i] = t;
+        t = static_cast<long_digit>(r[2 * i + 1]) + (sq >> digit_bits) + (t >> digit_bits);
+        r[2 * i + 1] = t;
+        carry = t >> digit_bits;
+    }
+    assert(carry == 0);
+}
+
+/*
+ * a = a0 + a1 * x, x = B^m, m = ceil(n / 2)
+ * a^2 = a0^2 + (a0^2 + a1^2 - (a0 - a1)^2) * x + a1^2 * x^2
+ *
+ * The scratch layout is the one of karatsuba_multiply with a single
+ * difference.
+ */
+void karatsuba_square(digit * r, const digit * a, size_t n, digit * scratch) {
+    size_t m = (n + 1) / 2;
+    size_t h = n - m;
+    digit * t  = scratch;
+    digit * d  = scratch + 2 * m;
+    digit * u  = scratch + 2 * m;
+    digit * rest = scratch + 4 * m + 1;
+    abs_diff(d, a, m, a + m, h);
+    square(t, d, m, rest);
+    square(r, a, m, rest);
+    square(r + 2 * m, a + m, h, rest);
+    u[2 * m] = add(u, r, 2 * m, r + 2 * m, 2 * h);
+    sub(u, u, 2 * m + 1, t, 2 * m);
+    size_t rn = 2 * n - m;
+    digit carry = add(r + m, r + m, rn, u, min(2 * m + 1, rn));
+    assert(carry == 0);
+    (void) carry;
+}
+
+size_t karatsuba_square_scratch_size(size_t n) {
+    size_t m = (n + 1) / 2;
+    return 4 * m + 1 + max(square_scratch_size(m), square_scratch_size(n - m));
+}
+
+// toom3_multiply with both operands evaluated at once.
+void toom3_square(digit * r, const digit * a, size_t n, digit * scratch) {
+    size_t k = (n + 2) / 3;
+    if (n <= 2 * k) return karatsuba_square(r, a, n, scratch);
+    size_t l = 2 * k + 2;
+    digit * w1   = scratch;
+    digit * wm1  = w1 + l;
+    digit * w2   = wm1 + l;
+    digit * ap   = w2 + l;
+    digit * am   = ap + k + 1;
+    digit * at   = am + k + 1;
+    digit * rest = at + k + 1;
+
+    square(r, a, k, rest);
+    square(r + 4 * k, a + 2 * k, n - 2 * k, rest);
+    toom_evaluate_pm(ap, am, at, a, n, k, 1);
+    square(w1, ap, k + 1, rest);
+    square(wm1, am, k + 1, rest);
+    toom_evaluate(ap, a, n, k, 0, 1, 2);
+    square(w2, ap, k + 1, rest);
+    toom3_interpolate(r, 2 * n, k, w1, wm1, false, w2);
+}
+
+size_t toom3_square_scratch_size(size_t n) {
+    size_t k = (n + 2) / 3;
+    if (n <= 2 * k) return karatsuba_square_scratch_size(n);
+    return 3 * (2 * k + 2) + 3 * (k + 1) +
+        max(max(square_scratch_size(k), square_scratch_size(k + 1)),
+            square_scratch_size(n - 2 * k));
+}
+
+// toom4_multiply with both operands evaluated at once.
+void toom4_square(digit * r, const digit * a, size_t n, digit * scratch) {
+    size_t k = (n + 3) / 4;
+    if (n <= 3 * k) return toom3_square(r, a, n, scratch);
+    size_t l = 2 * k + 2;
+    digit * w1   = scratch;
+    digit * wm1  = w1 + l;
+    digit * w2   = wm1 + l;
+    digit * wm2  = w2 + l;
+    digit * w3   = wm2 + l;
+    digit * ap   = w3 + l;
+    digit * am   = ap + k + 1;
+    digit * at   = am + k + 1;
+    digit * rest = at + k + 1;
+
+    square(r, a, k, rest);
+    square(r + 6 * k, a + 3 * k, n - 3 * k, rest);
+    toom_evaluate_pm(ap, am, at, a, n, k, 1);
+    square(w1, ap, k + 1, rest);
+    square(wm1, am, k + 1, rest);
+    toom_evaluate_pm(ap, am, at, a, n, k, 2);
+    square(w2, ap, k + 1, rest);
+    square(wm2, am, k + 1, rest);
+    toom_evaluate(ap, a, n, k, 0, 1, 3);
+    square(w3, ap, k + 1, rest);
+    toom4_interpolate(r, 2 * n, k, w1, wm1, false, w2, wm2, false, w3);
+}
+
+size_t toom4_square_scratch_size(size_t n) {
+    size_t k = (n + 3) / 4;
+    if (n <= 3 * k) return toom3_square_scratch_size(n);
+    return 5 * (2 * k + 2) + 3 * (k + 1) +
+        max(max(square_scratch_size(k), square_scratch_size(k + 1)),
+            square_scratch_size(n - 3 * k));
+}
+
+void square(digit * r, const digit * a, size_t n, digit * scratch) {
+    if (n <= karatsuba_square_threshold) {
+        school_square(r, a, n);
+    } else if (n <= toom3_threshold) {
+        karatsuba_square(r, a, n, scratch);
+    } else if (n <= toom4_threshold) {
+        toom3_square(r, a, n, scratch);
+    } else if (n <= ntt_threshold || !ntt_supports(n, n)) {
+        toom4_square(r, a, n, scratch);
+    } else {
+        ntt_multiply(r, a, n, a, n, scratch);
+    }
+}
+
+size_t square_scratch_size(size_t n) {
+    if (n <= karatsuba_square_threshold) return 0;
+    if (n <= toom3_threshold) return karatsuba_square_scratch_size(n);
+    if (n <= toom4_threshold) return toom3_square_scratch_size(n);
+    if (n <= ntt_threshold || !ntt_supports(n, n)) return toom4_square_scratch_size(n);
+    return ntt_scratch_size(n, n);
+}
+
+}
+}
@@ -44,8 +44,8 @@ long measure_multiplication(size_t length, size_t threshold) {
 }
 
 int main() {
-    size_t low_threshold = 71;
-    size_t high_threshold = 320;
+    size_t low_threshold = 8;
+    size_t high_threshold = 56;
     cout << setw(10) << "threshold,";
     cout << setw(15) << "time(ms)\n";
     for (int i = 0; i < 100; ++i) {
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#include "big_uint.hpp"
+
+/*
+ * Pseudorandom number of exactly length digits for the given seed. When
+ * length is a multiple of 3 the lower half is all ones to exercise carries.
+ */
+inline big::big_uint make_number(std::size_t length, big::digit seed) {
+    big::digit_vector d(length);
+    for (std::size_t i = 0; i < length; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        d[i] = seed ^ (seed << 13);
+    }
+    if (length % 3 == 0) {
+        std::fill(d.begin(), d.begin() + length / 2, std::numeric_limits<big::digit>::max());
+    }
+    d[length - 1] |= 1;
+    return big::big_uint(std::move(d));
+}
@@ -17,6 +17,13 @@ void test_constructors() {
     test_constructors({ 0 }, { "0" });
     test_constructors({ 100 }, { "100" });
     test_constructors({ -100 }, { "-100" });
+    test_constructors({ 100 }, { "+100" });
+    test_constructors({ 0 }, { "-0" });
+    test_constructors({ 0 }, { "-" });
+    test_constructors({ 0 }, { "" });
+    test_constructors({ -42 }, { "-0042x7" });
+    test_constructors(big_int(big_uint()), { 0 });
+    test_constructors(big_int(big_uint("123456789012345678901")), { "123456789012345678901" });
 }
 
 void test_preincrement(big_int prev, const big_int & next) {
@@ -113,10 +120,36 @@ void test_addition_and_subtraction() {
     test_addition_and_subtraction(100, 100, 200);
 }
 
+void test_square() {
+    assert(big_int(0).square() == 0);
+    assert(big_int(-7).square() == 49);
+    big_int x{ "-123456789012345678901234567890" };
+    assert(x.square() == big_int{ "15241578753238836750495351562536198787501905199875019052100" });
+    assert(x.square() == x * x);
+    assert(x.pow(3) == x * x * x);
+    assert(x.square().satisfies_invariant());
+}
+
+void test_gcd() {
+    assert(gcd(big_int(12), big_int(-18)) == 6);
+    assert(gcd(big_int(-12), big_int(-18)) == 6);
+    assert(gcd(big_int(0), big_int(-5)) == 5);
+    assert(gcd(big_int(0), big_int(0)) == 0);
+    assert(lcm(big_int(-4), big_int(6)) == 12);
+    assert(lcm(big_int(-4), big_int(0)) == 0);
+    big_int x{ "-123456789012345678901234567890" };
+    big_int y{ "98765432109876543210987654321" };
+    assert(gcd(x * 35, y * -35) == gcd(x, y) * 35);
+    assert(lcm(x, y) * gcd(x, y) == x * -y);
+    assert(gcd(x, y).satisfies_invariant());
+}
+
 int main() {
     cout << "big_int_tests.cpp\n";
     test_constructors();
     test_increment_and_decrement();
+    test_square();
+    test_gcd();
     cout << "OK!\n";
     return 0;
 }
@@ -1,10 +1,14 @@
 #include "big_uint.hpp"
+#include "reciprocal.hpp"
+#include "barrett.hpp"
 #include "assert.hpp"
+#include "numbers.hpp"
 
 #include <tuple>
 #include <utility>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <vector>
 #include <sstream>
 #include <cassert>
@@ -13,9 +17,19 @@ using namespace big;
 using namespace std;
 
 static const digit      m  = numeric_limits<digit>::max();
-static const long_digit mm = numeric_limits<long_digit>::max();
+static const long_digit mm = ~long_digit(0);
 
-void test_constructor(big_uint x, deque<digit> y) {
+// std::to_string doesn't accept unsigned __int128 used in 64-bit digit mode.
+string long_digit_to_string(long_digit x) {
+    string result;
+    do {
+        result.insert(result.begin(), '0' + x % 10);
+        x /= 10;
+    } while (x);
+    return result;
+}
+
+void test_constructor(big_uint x, digit_vector y) {
     assert(x.digits() == y);
     assert(x.satisfies_invariant());
 }
@@ -31,14 +45,66 @@ void test_constructors() {
     test_constructor({ "256" }, { 256 });
     test_constructor({ "257" }, { 257 });
     test_constructor({ "255" }, { 255 });
-    test_constructor({ to_string(m) }, { m });
-    test_constructor({ to_string((long_digit) m + 1) }, { 0, 1 });
-    test_constructor({ to_string(mm) }, { m, m });
+    test_constructor({ long_digit_to_string(m) }, { m });
+    test_constructor({ long_digit_to_string((long_digit) m + 1) }, { 0, 1 });
+    test_constructor({ long_digit_to_string(mm) }, { m, m });
+    test_constructor({ "00000000001024" }, { 1024 });
+#if BIG_DIGIT_BITS == 32
     test_constructor({ "340282367000166625996085689103316680705" }, { 1, 1, 1, 1, 1});
     test_constructor({ "339942088881935131302157980349511352979684" }, 
             { 4324, 5453, 43262, 54626, 999 });
-    test_constructor({ "00000000001024" }, { 1024 });
     test_constructor({ "18446744090889420804" }, { 4, 4, 1 });
+#else
+    test_constructor({ "11579208923731619542984808674407458861744605645576916891904176080"
+            "3882641915905" }, { 1, 1, 1, 1, 1});
+    test_constructor({ "11567629714807887957104037342091204336543184347085054892787849729"
+            "5344660360728804" }, { 4324, 5453, 43262, 54626, 999 });
+    test_constructor({ "340282366920938463537161583726606417924" }, { 4, 4, 1 });
+#endif
+}
+
+void test_digits() {
+    big_uint x{ 1, 2, 3, 4, 5, 6 };
+    digit_view v = x.digits();
+    assert(v.size() == 6);
+    assert(v.front() == 1 && v.back() == 6);
+    assert(v == digit_vector({ 1, 2, 3, 4, 5, 6 }));
+    digit s = 0;
+    for (digit d : v) s += d;
+    assert(s == 21);
+    assert(v.data() == x.digits().data());
+}
+
+void test_import_digits() {
+    digit_vector d(100);
+    d[0] = 42;
+    d[98] = 1;
+    const digit * data = d.data();
+    big_uint x(move(d));
+    assert(x.digits().data() == data);
+    assert(x.digits().size() == 99);
+    assert(x.satisfies_invariant());
+    digit_vector e = x.release_digits();
+    assert(e.data() == data);
+    assert(x == 0u);
+    assert(x.satisfies_invariant());
+    allocator<digit> alloc;
+    digit * buffer = alloc.allocate(8);
+    buffer[0] = 7;
+    buffer[1] = 0;
+    big_uint y(digit_vector::adopt(buffer, 2, 8));
+    assert(y.digits().data() == buffer);
+    assert(y == 7u);
+    assert(y.satisfies_invariant());
+    const digit borrowed[] = { 5, 6, 0 };
+    big_uint z(digit_vector::borrow(borrowed, 3));
+    assert(z.digits().data() == borrowed);
+    assert(z.digits().size() == 2);
+    big_uint w = z;
+    z += 1u;
+    assert(z.digits().data() != borrowed);
+    assert(borrowed[0] == 5 && w == big_uint({ 5, 6 }) && z == big_uint({ 6, 6 }));
+    assert(z.satisfies_invariant());
 }
 
 void test_predecrement(big_uint prev, big_uint next) {
@@ -234,8 +300,13 @@ void test_divide_digit() {
     test_divide_digit({ 4 }, 2, { 2 }, 0);
     test_divide_digit({ m }, 2, { m / 2 }, 1);
     test_divide_digit({ 0, 1 }, 2, { m / 2 + 1 }, 0);
-    test_divide_digit({ 0, m }, 2, { 1u << (8 * sizeof(digit) - 1), m >> 1 }, 0);
-    test_divide_digit({ 0, m }, 4, { 3u << (8 * sizeof(digit) - 2), m >> 2 }, 0);
+    test_divide_digit({ 0, m }, 2, { digit(1) << (8 * sizeof(digit) - 1), m >> 1 }, 0);
+    test_divide_digit({ 0, m }, 4, { digit(3) << (8 * sizeof(digit) - 2), m >> 2 }, 0);
+    test_divide_digit({ m, m, m }, m, { 1, 1, 1 }, 0);
+    test_divide_digit({ m, m }, m - 1, { 2, 1 }, 3);
+    test_divide_digit({ 0, 0, 1 }, digit(1) << (8 * sizeof(digit) - 1), { 0, 2 }, 0);
+    test_divide_digit({ 7, 0, 1 }, digit(1) << (8 * sizeof(digit) - 1), { 0, 2 }, 7);
+    test_divide_digit({ m, m, 2 }, 3, { m, m }, 2);
     test_divide_digit({ "311543243254325435435441361748615345432543254325432543254325" }, 
             54354, { "5731744549698742234894237070843274559968783425790788962" }, 13777);
     test_divide_digit({ "43621874963271894632871946721389468932164" }, 2, 
@@ -421,6 +492,103 @@ void test_multiply() {
             { "139040925675082734651478887262280244116520657008305538586301011080688" });
 }
 
+void test_multiply_algorithms(size_t lhs_length, size_t rhs_length) {
+    big_uint lhs = make_number(lhs_length, lhs_length);
+    big_uint rhs = make_number(rhs_length, ~rhs_length);
+    big_uint expected = big_uint::school_multiply(lhs, rhs);
+    assert(expected.satisfies_invariant());
+    assert(expected.digits().size() + 1 >= lhs_length + rhs_length);
+    big_uint t = big_uint::karatsuba_multiply(lhs, rhs);
+    assert(t == expected);
+    assert(t.satisfies_invariant());
+    t = big_uint::toom3_multiply(lhs, rhs);
+    assert(t == expected);
+    assert(t.satisfies_invariant());
+    t = big_uint::toom4_multiply(lhs, rhs);
+    assert(t == expected);
+    assert(t.satisfies_invariant());
+    t = big_uint::ntt_multiply(lhs, rhs);
+    assert(t == expected);
+    assert(t.satisfies_invariant());
+    t = lhs * rhs;
+    assert(t == expected);
+    assert(t.satisfies_invariant());
+    t = rhs * lhs;
+    assert(t == expected);
+}
+
+void test_multiply_algorithms() {
+    size_t lengths[] = { 2, 3, 5, 17, 24, 25, 26, 47, 50, 64, 99, 100, 101, 257 };
+    size_t thresholds[][3] = { { 1, 2, 3 }, { 2, 4, 8 }, { 1, 100, 100 },
+                               { 24, 30, 60 }, { 24, 200, 600 } };
+    for (auto & threshold : thresholds) {
+        big_uint::set_karatsuba_threshold(threshold[0]);
+        big_uint::set_toom3_threshold(threshold[1]);
+        big_uint::set_toom4_threshold(threshold[2]);
+        for (size_t lhs_length : lengths) {
+            for (size_t rhs_length : lengths) {
+                test_multiply_algorithms(lhs_length, rhs_length);
+            }
+        }
+    }
+    big_uint::set_karatsuba_threshold(24);
+    big_uint::set_toom3_threshold(200);
+    big_uint::set_toom4_threshold(600);
+    test_multiply_algorithms(1000, 1000);
+    test_multiply_algorithms(1000, 700);
+    test_multiply_algorithms(3000, 100);
+    test_multiply_algorithms(2000, 900);
+    test_multiply_algorithms(1001, 333);
+    test_multiply_algorithms(5000, 1700);
+    big_uint::set_ntt_threshold(100);
+    test_multiply_algorithms(1000, 700);
+    big_uint::set_ntt_threshold(BIG_DIGIT_BITS == 32 ? 4000 : 16000);
+}
+
+void test_ntt_multiply() {
+    // All the coefficients of the convolution are at their maximum.
+    size_t n = 3000;
+    big_uint x(digit_vector(n, ~digit(0)));
+    digit_vector square(2 * n, ~digit(0));
+    square[0] = 1;
+    fill(square.begin() + 1, square.begin() + n, 0);
+    square[n] = ~digit(1);
+    big_uint expected(move(square));
+    assert(big_uint::ntt_multiply(x, x) == expected);
+    assert(x * x == expected);
+}
+
+void test_square(size_t length) {
+    big_uint x = make_number(length, length);
+    big_uint expected = big_uint::school_multiply(x, x);
+    big_uint t = x.square();
+    assert(t == expected);
+    assert(t.satisfies_invariant());
+    t = x;
+    t *= t;
+    assert(t == expected);
+}
+
+void test_square() {
+    size_t thresholds[][4] = { { 1, 2, 3, 1000 }, { 2, 4, 8, 1000 },
+                               { 1, 100, 100, 1000 }, { 24, 30, 60, 100 },
+                               { 48, 200, 600, 1000 } };
+    for (auto & threshold : thresholds) {
+        big_uint::set_karatsuba_square_threshold(threshold[0]);
+        big_uint::set_toom3_threshold(threshold[1]);
+        big_uint::set_toom4_threshold(threshold[2]);
+        big_uint::set_ntt_threshold(threshold[3]);
+        for (size_t length = 1; length < 70; ++length) test_square(length);
+        for (size_t length : { 99, 100, 101, 257, 1000 }) test_square(length);
+    }
+    big_uint::set_karatsuba_square_threshold(48);
+    big_uint::set_toom3_threshold(200);
+    big_uint::set_toom4_threshold(600);
+    big_uint::set_ntt_threshold(BIG_DIGIT_BITS == 32 ? 4000 : 16000);
+    assert(big_uint(0u).square() == 0u);
+    assert(big_uint({ 0, 1 }).square() == big_uint({ 0, 0, 1 }));
+}
+
 void test_divide(const big_uint & dividend, const big_uint & divisor, 
         const big_uint & quotient) {
     big_uint t = dividend / divisor;
@@ -449,6 +617,260 @@ void test_divide(const big_uint & dividend, const big_uint & divisor,
     test_modulo(dividend, divisor, reminder);
 }
 
+void test_divide_algorithms(const big_uint & dividend, const big_uint & divisor) {
+    big_uint reminder;
+    big_uint quotient = big_uint::div(dividend, divisor, reminder);
+    assert(quotient.satisfies_invariant());
+    assert(reminder.satisfies_invariant());
+    assert(reminder < divisor);
+    assert(quotient * divisor + reminder == dividend);
+}
+
+void test_divide_algorithms() {
+    size_t lengths[] = { 1, 2, 3, 5, 17, 24, 25, 64, 100, 257 };
+    for (size_t threshold : { 1, 4, 5, 9, 40 }) {
+        big_uint::set_burnikel_ziegler_threshold(threshold);
+        for (size_t dividend_length : lengths) {
+            for (size_t divisor_length : lengths) {
+                big_uint dividend = make_number(dividend_length, dividend_length);
+                big_uint divisor = make_number(divisor_length, ~divisor_length);
+                test_divide_algorithms(dividend, divisor);
+                test_divide_algorithms(dividend * divisor + divisor - 1u, divisor);
+            }
+        }
+    }
+    big_uint::set_burnikel_ziegler_threshold(40);
+    for (size_t threshold : { 2, 3, 17 }) {
+        big_uint::set_newton_threshold(threshold);
+        for (size_t dividend_length : lengths) {
+            for (size_t divisor_length : lengths) {
+                big_uint dividend = make_number(dividend_length, dividend_length);
+                big_uint divisor = make_number(divisor_length, ~divisor_length);
+                test_divide_algorithms(dividend * divisor + divisor - 1u, divisor);
+            }
+        }
+    }
+    big_uint::set_newton_threshold(BIG_DIGIT_BITS == 32 ? 20000 : 60000);
+    big_uint x = make_number(3000, 1);
+    big_uint y = make_number(1100, 2);
+    test_divide_algorithms(x, y);
+    test_divide_algorithms(x * y + y - 1u, y);
+    test_divide_algorithms(x * x, x + 1u);
+    // Quotient digits whose first estimate is too large.
+    big_uint b({ 0, 0, digit(1) << (BIG_DIGIT_BITS - 1) });
+    big_uint a({ 0, m, m - 1, m >> 1 });
+    test_divide_algorithms(a, b);
+    test_divide_algorithms(a, b + 1u);
+    test_divide_algorithms(a, b - 1u);
+    test_divide_algorithms(big_uint({ m, m, m, m }), big_uint({ m, m }));
+    test_divide_algorithms(big_uint({ 0, 0, 0, 1 }), big_uint({ 1, 0, 1 }));
+    test_divide_algorithms(big_uint({ 3, 0, 0x8000, 0x7fff }), big_uint({ 1, 0, 0x8000 }));
+}
+
+void test_reciprocal(const big_uint & divisor) {
+    reciprocal r(divisor);
+    assert(r.divisor() == divisor);
+    for (size_t length : { 1, 2, 7, 40, 121, 300 }) {
+        big_uint dividend = make_number(length, length);
+        big_uint reminder;
+        big_uint quotient = r.div(dividend, reminder);
+        assert(quotient == dividend / divisor);
+        assert(reminder == dividend % divisor);
+        assert(r.div(dividend) == quotient);
+        assert(r.mod(dividend) == reminder);
+        big_uint product = dividend * divisor;
+        assert(r.div(product, reminder) == dividend);
+        assert(reminder == 0u);
+        assert(r.div(product - 1u) == dividend - 1u);
+    }
+}
+
+void test_reciprocal() {
+    for (size_t length : { 1, 2, 3, 9, 10, 33, 100 }) {
+        test_reciprocal(make_number(length, ~length));
+        test_reciprocal(big_uint(digit_vector(length, m)));
+        digit_vector power(length);
+        power.back() = digit(1) << (BIG_DIGIT_BITS - 1);
+        test_reciprocal(big_uint(power));
+        power.back() = 1;
+        test_reciprocal(big_uint(move(power)));
+    }
+}
+
+void test_barrett(const big_uint & modulus) {
+    barrett_context b(modulus);
+    assert(b.modulus() == modulus);
+    size_t n = modulus.digits().size();
+    for (size_t length : { size_t(1), n, n + 1, 2 * n - 1, 2 * n, 2 * n + 1, 3 * n + 5 }) {
+        big_uint x = make_number(length, length + n);
+        big_uint r = b.reduce(x);
+        assert(r == x % modulus && r.satisfies_invariant());
+        assert(b.reduce(x * modulus) == 0u);
+    }
+    big_uint top = modulus - 1u;
+    assert(b.reduce(top * top) == top * top % modulus);
+    assert(b.sqr_mod(top) == top * top % modulus);
+    big_uint x = make_number(n, 7) % modulus;
+    big_uint y = make_number(n, 8) % modulus;
+    assert(b.mul_mod(x, y) == x * y % modulus);
+    assert(b.mul_mod(x, top) == x * top % modulus);
+    assert(b.sqr_mod(x) == x * x % modulus);
+    assert(b.reduce(modulus) == 0u && b.reduce(top) == top);
+}
+
+void test_barrett() {
+    test_barrett(big_uint(1));
+    test_barrett(big_uint(2));
+    for (size_t length : { 1, 2, 3, 9, 10, 33, 100 }) {
+        test_barrett(make_number(length, length));
+        test_barrett(make_number(length, length) - 1u + (length == 1 ? 2u : 0u));
+        test_barrett(big_uint(digit_vector(length, m)));
+        digit_vector power(length);
+        power.back() = 1;
+        test_barrett(big_uint(move(power)));
+    }
+}
+
+string to_decimal(big_uint x) {
+    string result;
+    do {
+        result.insert(result.begin(), '0' + (x % 10).digits()[0]);
+        x /= 10;
+    } while (x != 0u);
+    return result;
+}
+
+void test_output(const big_uint & x) {
+    ostringstream os;
+    os << x;
+    assert(os.str() == to_decimal(x));
+    assert(big_uint(os.str()) == x);
+}
+
+void test_output() {
+    test_output(big_uint());
+    test_output(big_uint(7));
+    test_output(big_uint(m));
+    test_output(big_uint({ 0, 1 }));
+    for (size_t threshold : { 2, 3, 30 }) {
+        big_uint::set_radix_threshold(threshold);
+        for (size_t length : { 1, 2, 3, 4, 7, 16, 33, 100, 250 }) {
+            big_uint x = make_number(length, length);
+            test_output(x);
+            test_output(x - 1u);
+            test_output(big_uint(digit_vector(length, m)));
+            big_uint p = big_uint(10).pow(length * BIG_DIGIT_BITS * 3 / 10);
+            test_output(p);
+            test_output(p - 1u);
+        }
+    }
+    big_uint::set_radix_threshold(30);
+    // Long enough for the powers of ten to keep their reciprocals.
+    big_uint x = make_number(5000, 5);
+    ostringstream os, school;
+    os << x;
+    big_uint::set_radix_threshold(numeric_limits<size_t>::max());
+    school << x;
+    big_uint::set_radix_threshold(30);
+    assert(os.str() == school.str());
+}
+
+string stream_output(const big_uint & x, ios_base::fmtflags flags) {
+    ostringstream os;
+    os.flags(flags);
+    os << x;
+    return os.str();
+}
+
+void test_output_base() {
+    big_uint x("80191811329");
+    assert(stream_output(x, ios_base::hex) == "12abcdef01");
+    assert(stream_output(x, ios_base::hex | ios_base::uppercase) == "12ABCDEF01");
+    assert(stream_output(x, ios_base::hex | ios_base::showbase) == "0x12abcdef01");
+    assert(stream_output(x, ios_base::hex | ios_base::showbase | ios_base::uppercase) ==
+           "0X12ABCDEF01");
+    assert(stream_output(x, ios_base::oct) == "1125363367401");
+    assert(stream_output(x, ios_base::oct | ios_base::showbase) == "01125363367401");
+    assert(stream_output(x, ios_base::fmtflags()) == "80191811329");
+    assert(stream_output(big_uint(), ios_base::hex | ios_base::showbase) == "0");
+    assert(stream_output(big_uint(), ios_base::oct | ios_base::showbase) == "0");
+    big_uint y = make_number(100, 3);
+    big_uint z;
+    istringstream(stream_output(y, ios_base::hex)) >> hex >> z;
+    assert(z == y);
+    istringstream(stream_output(y, ios_base::oct)) >> oct >> z;
+    assert(z == y);
+}
+
+big_uint from_decimal(const string & s) {
+    big_uint x;
+    for (char c : s) {
+        x *= 10;
+        x += c - '0';
+    }
+    return x;
+}
+
+void test_input(const string & s) {
+    big_uint x = from_decimal(s);
+    assert(big_uint(s) == x);
+    assert(big_uint(s + "x123") == x);
+    assert(big_uint("000" + s) == x);
+    istringstream is(s + " 42");
+    big_uint y;
+    is >> y;
+    assert(y == x);
+    assert(y.satisfies_invariant());
+    assert(is.get() == ' ');
+}
+
+void test_input() {
+    test_input("");
+    test_input("0");
+    test_input("000");
+    test_input(long_digit_to_string(m));
+    test_input(long_digit_to_string(mm));
+    string digits;
+    for (size_t i = 0; i < 3000; ++i) digits.push_back('0' + (i * i + 7 * i) % 10);
+    for (size_t threshold : { 2, 3, 30 }) {
+        big_uint::set_radix_threshold(threshold);
+        for (size_t length : { 1, 8, 9, 10, 18, 19, 20, 37, 38, 39, 100, 171, 999, 3000 }) {
+            test_input(digits.substr(0, length));
+            test_input(string(length, '9'));
+            test_input("1" + string(length, '0'));
+        }
+    }
+    big_uint::set_radix_threshold(30);
+}
+
+big_uint stream_input(const string & s, ios_base::fmtflags flags, const string & rest) {
+    istringstream is(s + rest);
+    is.flags(flags);
+    big_uint x(7);
+    is >> x;
+    assert(x.satisfies_invariant());
+    string tail;
+    getline(is, tail);
+    assert(tail == rest);
+    return x;
+}
+
+void test_input_base() {
+    big_uint x("80191811329");
+    assert(stream_input("12abcdef01", ios_base::hex, " 1") == x);
+    assert(stream_input("12ABCDEF01", ios_base::hex, "g") == x);
+    assert(stream_input("0x12abcdef01", ios_base::hex, "") == x);
+    assert(stream_input("0X12abcdef01", ios_base::fmtflags(), " ") == x);
+    assert(stream_input("1125363367401", ios_base::oct, "8") == x);
+    assert(stream_input("01125363367401", ios_base::fmtflags(), "9") == x);
+    assert(stream_input("80191811329", ios_base::fmtflags(), "a") == x);
+    assert(stream_input("0", ios_base::fmtflags(), "") == 0u);
+    assert(stream_input("0", ios_base::hex, "g") == 0u);
+    assert(stream_input("0x", ios_base::hex, "") == 0u);
+    assert(stream_input("012", ios_base::dec, "") == 12u);
+    assert(stream_input("0", ios_base::dec, "x1") == 0u);
+}
+
 void test_divide() {
     test_divide({ 0 }, { 1 }, { 0 }, { 0 });
     test_divide({ 1 }, { 2 }, { 0 }, { 1 });
@@ -971,6 +1393,7 @@ void test_pow() {
     test_pow({ 2 }, 2, { 4 });
     test_pow({ 42 }, 2, { 1764 });
     test_pow({ m }, 2, { 1, m - 1 });
+#if BIG_DIGIT_BITS == 32
     test_pow({ 0, 1 }, 2, { "18446744073709551616" });
     test_pow({ 1, 1 }, 2, { "18446744082299486209" });
     test_pow({ 2, 1 }, 2, { "18446744090889420804" });
@@ -981,6 +1404,28 @@ void test_pow() {
     test_pow({ 2, m }, 2, { "340282366762482138527079652596048199684" });
     test_pow({ 42, m }, 2, { "340282366762482140002819178149214947044" });
     test_pow({ m, m }, 2, { "340282366920938463426481119284349108225" });
+#else
+    test_pow({ 0, 1 }, 2, { "340282366920938463463374607431768211456" });
+    test_pow({ 1, 1 }, 2, { "340282366920938463500268095579187314689" });
+    test_pow({ 2, 1 }, 2, { "340282366920938463537161583726606417924" });
+    test_pow({ 42, 1 }, 2, { "340282366920938465012901109623370548964" });
+    test_pow({ m, 1 }, 2, { "1361129467683753853779711453432234639361" });
+    test_pow({ 0, m }, 2,
+            { "11579208923731619541101678153791454632593868818614616967071624772641"
+            "6828825600" });
+    test_pow({ 1, m }, 2,
+            { "11579208923731619541101678153791454632661925291998804659760610345313"
+            "2946145281" });
+    test_pow({ 2, m }, 2,
+            { "11579208923731619541101678153791454632729981765382992352449595917984"
+            "9063464964" });
+    test_pow({ 42, m }, 2,
+            { "11579208923731619541101678153791454635452240700750500060009018824849"
+            "3756253924" });
+    test_pow({ m, m }, 2,
+            { "11579208923731619542357098500868790785258941993179868711253083479304"
+            "9593217025" });
+#endif
     test_pow({ "3143271849327891473289789789374282" }, 2, 
             { "9880157918777182876145376146391788801255400268620362724753083015524" });
     test_pow({ "4738291477084372891789473829478932" }, 2, 
@@ -1030,9 +1475,108 @@ void test_pow() {
             "3994015881285443648764403952305187580493448759701619748714315776" });
 }
 
+big_uint reference_pow_mod(const big_uint & base, const big_uint & e, const big_uint & mod) {
+    big_uint result = big_uint(1) % mod;
+    digit_view d = e.digits();
+    for (size_t i = d.size() * BIG_DIGIT_BITS; i-- > 0; ) {
+        result = result * result % mod;
+        if (d[i / BIG_DIGIT_BITS] >> (i % BIG_DIGIT_BITS) & 1) result = result * base % mod;
+    }
+    return result;
+}
+
+void test_pow_mod(const big_uint & base, const big_uint & e, const big_uint & mod) {
+    big_uint r = base.pow_mod(e, mod);
+    assert(r == reference_pow_mod(base % mod, e, mod));
+    assert(r.satisfies_invariant());
+}
+
+void test_pow_mod() {
+    test_pow_mod(big_uint(3), big_uint(), big_uint(1));
+    test_pow_mod(big_uint(3), big_uint(5), big_uint(1));
+    test_pow_mod(big_uint(), big_uint(), big_uint(7));
+    test_pow_mod(big_uint(), big_uint(5), big_uint(7));
+    test_pow_mod(big_uint(3), big_uint(200), big_uint(1000));
+    test_pow_mod(big_uint(m), big_uint(m), big_uint(m));
+    for (size_t length : { 1, 2, 3, 5, 17, 40 }) {
+        big_uint odd = make_number(length, length);
+        big_uint even = odd - 1u + (length == 1 ? 2u : 0u);
+        for (const big_uint & mod : { odd, even }) {
+            for (size_t el : { 1, 2, 7 }) {
+                big_uint e = make_number(el, el + length);
+                test_pow_mod(big_uint(), e, mod);
+                test_pow_mod(big_uint(1), e, mod);
+                test_pow_mod(mod - 1u, e, mod);
+                test_pow_mod(make_number(length + 2, 5), e, mod);
+                test_pow_mod(make_number(length, 9), big_uint(2).pow(digit(el * 40)), mod);
+            }
+            test_pow_mod(make_number(length, 3), big_uint(), mod);
+        }
+    }
+    // Fermat's little theorem for the Mersenne primes 2^127 - 1 and 2^521 - 1.
+    for (size_t p : { 127, 521 }) {
+        big_uint prime = big_uint(2).pow(digit(p)) - 1u;
+        for (digit a : { 2, 3, 12345 }) {
+            assert(big_uint(a).pow_mod(prime - 1u, prime) == 1u);
+            big_uint x = make_number(5, a) % prime;
+            assert(x.pow_mod(prime, prime) == x);
+        }
+    }
+}
+
+big_uint reference_gcd(big_uint a, big_uint b) {
+    while (b != 0u) {
+        a %= b;
+        swap(a, b);
+    }
+    return a;
+}
+
+void test_gcd(const big_uint & a, const big_uint & b) {
+    big_uint g = gcd(a, b);
+    assert(g == reference_gcd(a, b));
+    assert(g == gcd(b, a));
+    assert(g.satisfies_invariant());
+    if (g != 0u) assert(lcm(a, b) == a / g * b);
+}
+
+void test_gcd() {
+    test_gcd(big_uint(), big_uint());
+    test_gcd(big_uint(), big_uint(5));
+    test_gcd(big_uint(12), big_uint(18));
+    test_gcd(big_uint(m), big_uint(m - 1));
+    assert(gcd(big_uint(12), big_uint(18)) == 6u);
+    assert(lcm(big_uint(12), big_uint(18)) == 36u);
+    assert(lcm(big_uint(), big_uint(18)) == 0u);
+    assert(gcd(big_uint(2).pow(300), big_uint(2).pow(200) * 3u) == big_uint(2).pow(200));
+    // Lengths up to past the half-gcd threshold.
+    for (size_t length : { 1, 2, 3, 4, 10, 60, 200, 500, 900 }) {
+        big_uint a = make_number(length, length);
+        big_uint b = make_number(length, ~length);
+        big_uint c = make_number(length / 3 + 1, 7);
+        test_gcd(a, b);
+        test_gcd(a * c, b * c);
+        test_gcd(a * c, c);
+        test_gcd(a, a + 1u);
+        test_gcd(a * c, a * c + c);
+        test_gcd(a * b, b);
+        test_gcd(make_number(2 * length, 3) * c, b * c);
+    }
+    // Consecutive Fibonacci numbers have the longest remainder sequence.
+    big_uint f0(1), f1(1);
+    for (int i = 0; i < 5000; ++i) {
+        f0 += f1;
+        swap(f0, f1);
+    }
+    assert(gcd(f0, f1) == 1u);
+    assert(gcd(f1 * f1, f0 * f1) == f1);
+}
+
 int main() {
     cout << "big_uint_tests.cpp\n";
     test_constructors();
+    test_digits();
+    test_import_digits();
     test_increment_and_decrement();
     test_add_digit();
     test_subtract_digit();
@@ -1042,9 +1586,21 @@ int main() {
     test_reverse_divide_digit();
     test_add_and_subtract();
     test_multiply();
+    test_multiply_algorithms();
+    test_ntt_multiply();
+    test_square();
     test_divide();
+    test_divide_algorithms();
+    test_reciprocal();
+    test_barrett();
+    test_output();
+    test_output_base();
+    test_input();
+    test_input_base();
     test_comparisons();
     test_comparisons_digit();
     test_pow();
+    test_pow_mod();
+    test_gcd();
     cout << "OK!" << endl;
 }
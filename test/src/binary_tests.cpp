@@ -0,0 +1,210 @@
+#include "binary.hpp"
+#include "assert.hpp"
+#include "numbers.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace big;
+
+static const digit m = numeric_limits<digit>::max();
+
+big_int make_number(size_t length, digit seed, bool negative) {
+    big_int x(make_number(length, seed));
+    return negative ? -x : x;
+}
+
+vector<big_int> sample() {
+    vector<big_int> result = { 0, 1, -1, 63, -64, big_int(big_uint(m)) };
+    for (size_t length : { 1, 2, 3, 5, 64, 1000 }) {
+        result.push_back(make_number(length, length, length % 2));
+        result.push_back(make_number(length, length + 1, length % 2 == 0));
+    }
+    return result;
+}
+
+string write_sample(const vector<big_int> & numbers) {
+    ostringstream os;
+    binary_writer writer(os);
+    for (const big_int & x : numbers) writer.write(x);
+    return os.str();
+}
+
+void test_round_trip() {
+    vector<big_int> numbers = sample();
+    string data = write_sample(numbers);
+    binary_reader reader(data.data(), data.data() + data.size());
+    big_int x;
+    for (const big_int & y : numbers) {
+        assert(reader.read(x));
+        assert(x == y && x.satisfies_invariant());
+    }
+    assert(reader.at_end() && !reader.read(x));
+
+    ostringstream os;
+    binary_writer(os).write(big_uint()).write(big_uint(m)).write(big_uint(5));
+    string s = os.str();
+    // Header, a byte of zero, then a byte, padding and a limb each.
+    assert(s.size() == (sizeof(digit) == 4 ? 24u : 40u));
+    binary_reader r(s.data(), s.data() + s.size());
+    big_uint u(7);
+    assert(r.read(u) && u == 0u);
+    assert(r.read(u) && u == m);
+    assert(r.read(u) && u == 5u);
+    assert(!r.read(u));
+}
+
+void test_limb_bytes() {
+    // 2^32 + 5 with four and eight byte limbs.
+    const char four[] = { 'b', 'i', 'g', 'n', 1, 4, 0, 0, 4, 0, 0, 0,
+                          5, 0, 0, 0, 1, 0, 0, 0 };
+    const char eight[] = { 'b', 'i', 'g', 'n', 1, 8, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0,
+                           5, 0, 0, 0, 1, 0, 0, 0 };
+    big_uint expected("4294967301");
+    for (auto data : { string(four, sizeof(four)), string(eight, sizeof(eight)) }) {
+        binary_reader reader(data.data(), data.data() + data.size());
+        big_uint x;
+        assert(reader.read(x));
+        assert(x == expected && x.satisfies_invariant());
+        assert(reader.at_end());
+    }
+}
+
+template <typename T>
+void assert_malformed(const string & data, T x) {
+    bool thrown = false;
+    try {
+        binary_reader reader(data.data(), data.data() + data.size());
+        while (reader.read(x)) { }
+    } catch (const runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_malformed() {
+    string header("bign\1\4\0\0", 8);
+    assert_malformed("", big_uint());
+    assert_malformed("bigx\1\4\0\0", big_uint());
+    assert_malformed(string("bign\2\4\0\0", 8), big_uint());
+    assert_malformed(string("bign\1\3\0\0", 8), big_uint());
+    // Truncated limbs and varint.
+    assert_malformed(header + string("\4\0\0\0\5\0\0\0", 8), big_uint());
+    assert_malformed(header + "\x80", big_uint());
+    // Negative zero, zero top limb, negative into big_uint.
+    assert_malformed(header + "\1", big_int());
+    assert_malformed(header + string("\2\0\0\0\0\0\0\0", 8), big_uint());
+    assert_malformed(header + string("\3\0\0\0\5\0\0\0", 8), big_uint());
+    big_int x;
+    string data = header + string("\3\0\0\0\5\0\0\0", 8);
+    binary_reader reader(data.data(), data.data() + data.size());
+    assert(reader.read(x) && x == -5);
+}
+
+void test_mapped_file() {
+    const char * path = "binary_tests.tmp";
+    vector<big_int> numbers = sample();
+    {
+        ofstream file(path, ios::binary);
+        file << write_sample(numbers);
+    }
+    {
+        mapped_file file(path);
+        binary_reader reader(file);
+        vector<big_int> read;
+        big_int x;
+        while (reader.read(x)) read.push_back(move(x));
+        assert(read == numbers);
+        // Modified and outgrown numbers leave the file as it was.
+        for (big_int & z : read) {
+            z += 1;
+            z *= z;
+        }
+        mapped_file same(path);
+        binary_reader again(same);
+        for (const big_int & z : numbers) {
+            assert(again.read(x) && x == z);
+        }
+    }
+    {
+        ofstream file(path, ios::binary);
+        binary_writer(file).write(big_uint()).write(big_uint(m)).write(big_uint({ 1, 2, 3 }));
+    }
+    {
+        mapped_file file(path);
+        binary_reader reader(file);
+        big_uint x;
+        assert(reader.read(x) && x == 0u);
+        for (size_t i = 0; i < 2; ++i) {
+            assert(reader.read(x));
+            const char * p = reinterpret_cast<const char *>(x.digits().data());
+            assert(p >= file.data() && p < file.data() + file.size());
+        }
+        assert(x == big_uint({ 1, 2, 3 }));
+
+        // Numbers read twice from the same bytes don't share them.
+        binary_reader first(file), second(file);
+        big_uint y, z;
+        for (size_t i = 0; i < 3; ++i) assert(first.read(y) && second.read(z));
+        y *= 3u;
+        assert(y == big_uint({ 3, 6, 9 }) && z == big_uint({ 1, 2, 3 }));
+        // Shrinking one leaves the bytes canonical for later readers.
+        z -= big_uint({ 0, 0, 3 });
+        assert(z == big_uint({ 1, 2 }));
+        binary_reader third(file);
+        for (size_t i = 0; i < 3; ++i) assert(third.read(x));
+        assert(x == big_uint({ 1, 2, 3 }));
+
+        // Operations in place copy the limbs out of the read only mapping.
+        const big_uint w({ 1, 2, 3 });
+        vector<function<void(big_uint &)>> operations = {
+            [](big_uint & u) { ++u; },
+            [](big_uint & u) { --u; },
+            [](big_uint & u) { u += 5u; },
+            [](big_uint & u) { u -= 5u; },
+            [](big_uint & u) { u *= 7u; },
+            [](big_uint & u) { u /= 7u; },
+            [](big_uint & u) { u %= 7u; },
+            [](big_uint & u) { u = 9u; },
+            [&](big_uint & u) { u += w; },
+            [](big_uint & u) { u -= big_uint({ 0, 0, 3 }); },
+            [](big_uint & u) { u *= u; },
+            [](big_uint & u) { u /= big_uint({ 0, 1 }); },
+            [](big_uint & u) { u.release_digits()[0] = 1; },
+        };
+        for (auto & operation : operations) {
+            binary_reader reader(file);
+            big_uint u, v = w;
+            for (size_t i = 0; i < 3; ++i) assert(reader.read(u));
+            operation(u);
+            operation(v);
+            assert(u == v && u.satisfies_invariant());
+        }
+    }
+    remove(path);
+    bool thrown = false;
+    try {
+        mapped_file missing("binary_tests.missing");
+    } catch (const system_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+int main() {
+    cout << "binary_tests.cpp\n";
+    test_round_trip();
+    test_limb_bytes();
+    test_malformed();
+    test_mapped_file();
+    cout << "OK!\n";
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "charconv.hpp"
+#include "assert.hpp"
+#include "numbers.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace big;
+
+static const digit m = numeric_limits<digit>::max();
+
+string reference(big_uint x, int base) {
+    const char symbols[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    string result;
+    do {
+        result.insert(result.begin(), symbols[(x % digit(base)).digits()[0]]);
+        x /= digit(base);
+    } while (x != 0u);
+    return result;
+}
+
+void test_to_chars(const big_uint & x, int base) {
+    string expected = reference(x, base);
+    assert(to_chars_size(x, base) == expected.size());
+    vector<char> buffer(expected.size() + 40, '#');
+    to_chars_result r = to_chars(buffer.data(), buffer.data() + buffer.size(), x, base);
+    assert(r.ec == errc());
+    assert(string(buffer.data(), r.ptr) == expected);
+    r = to_chars(buffer.data(), buffer.data() + expected.size(), x, base);
+    assert(r.ec == errc() && r.ptr == buffer.data() + expected.size());
+    assert(string(buffer.data(), r.ptr) == expected);
+    r = to_chars(buffer.data(), buffer.data() + expected.size() - 1, x, base);
+    assert(r.ec == errc::value_too_large);
+    assert(r.ptr == buffer.data() + expected.size() - 1);
+
+    assert(to_string(x, base) == expected);
+
+    big_uint y(12345);
+    from_chars_result f = from_chars(expected.data(), expected.data() + expected.size(), y, base);
+    assert(f.ec == errc() && f.ptr == expected.data() + expected.size());
+    assert(y == x && y.satisfies_invariant());
+    string upper = "00" + expected + "!";
+    transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    f = from_chars(upper.data(), upper.data() + upper.size(), y, base);
+    assert(f.ec == errc() && f.ptr == upper.data() + upper.size() - 1);
+    assert(y == x);
+}
+
+void test_to_chars() {
+    for (size_t threshold : { 2, 30 }) {
+        big_uint::set_radix_threshold(threshold);
+        for (int base = 2; base <= 36; ++base) {
+            test_to_chars(big_uint(), base);
+            test_to_chars(big_uint(1), base);
+            test_to_chars(big_uint(base - 1), base);
+            test_to_chars(big_uint(base), base);
+            test_to_chars(big_uint(m), base);
+            for (size_t length : { 1, 2, 5, 40 }) {
+                test_to_chars(make_number(length, length + base), base);
+            }
+            for (digit e : { 1, 2, 31, 32, 33, 300 }) {
+                big_uint p = big_uint(base).pow(e);
+                test_to_chars(p, base);
+                test_to_chars(p - 1u, base);
+            }
+        }
+    }
+    big_uint::set_radix_threshold(30);
+}
+
+void test_from_chars_errors() {
+    big_uint x(7);
+    const char none[] = "xyz";
+    from_chars_result f = from_chars(none, none + 3, x);
+    assert(f.ec == errc::invalid_argument && f.ptr == none && x == 7u);
+    f = from_chars(none, none, x);
+    assert(f.ec == errc::invalid_argument && f.ptr == none && x == 7u);
+    const char nine[] = "9";
+    f = from_chars(nine, nine + 1, x, 8);
+    assert(f.ec == errc::invalid_argument && x == 7u);
+    const char minus[] = "-5";
+    f = from_chars(minus, minus + 2, x);
+    assert(f.ec == errc::invalid_argument && x == 7u);
+    const char space[] = " 5";
+    f = from_chars(space, space + 2, x);
+    assert(f.ec == errc::invalid_argument && x == 7u);
+}
+
+void test_big_int(const big_int & x, const string & text, int base) {
+    assert(to_chars_size(x, base) == text.size());
+    vector<char> buffer(text.size());
+    to_chars_result r = to_chars(buffer.data(), buffer.data() + buffer.size(), x, base);
+    assert(r.ec == errc() && string(buffer.data(), r.ptr) == text);
+    assert(to_string(x, base) == text);
+    r = to_chars(buffer.data(), buffer.data() + buffer.size() - 1, x, base);
+    assert(r.ec == errc::value_too_large);
+    big_int y(42);
+    from_chars_result f = from_chars(text.data(), text.data() + text.size(), y, base);
+    assert(f.ec == errc() && f.ptr == text.data() + text.size());
+    assert(y == x && y.satisfies_invariant());
+}
+
+void test_big_int() {
+    test_big_int(0, "0", 10);
+    test_big_int(-1, "-1", 10);
+    test_big_int(-255, "-ff", 16);
+    test_big_int(big_int("-123456789012345678901234567890"),
+                 "-123456789012345678901234567890", 10);
+    big_int x(42);
+    const char * bad[] = { "-", "+1", "--1", "" };
+    for (const char * s : bad) {
+        from_chars_result f = from_chars(s, s + strlen(s), x);
+        assert(f.ec == errc::invalid_argument && f.ptr == s && x == 42);
+    }
+    const char zero[] = "-0";
+    from_chars(zero, zero + 2, x);
+    assert(x == 0 && x.satisfies_invariant() && x.sign() == big_int::sign_t::PLUS);
+    char one[1];
+    assert(to_chars(one, one + 1, big_int(-1)).ec == errc::value_too_large);
+    assert(to_chars(one, one, big_int(-1)).ec == errc::value_too_large);
+}
+
+int main() {
+    cout << "charconv_tests.cpp\n";
+    test_to_chars();
+    test_from_chars_errors();
+    test_big_int();
+    cout << "OK!\n";
+    return 0;
+}
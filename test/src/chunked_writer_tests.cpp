@@ -0,0 +1,125 @@
+#include "chunked_writer.hpp"
+#include "charconv.hpp"
+#include "assert.hpp"
+#include "numbers.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace big;
+
+static const digit m = numeric_limits<digit>::max();
+
+// Records the pieces written to it.
+class recording_buf : public streambuf {
+public:
+    string         text;
+    vector<size_t> pieces;
+
+protected:
+    streamsize xsputn(const char * s, streamsize n) override {
+        text.append(s, n);
+        pieces.push_back(n);
+        return n;
+    }
+
+    int_type overflow(int_type c) override {
+        text.push_back(traits_type::to_char_type(c));
+        pieces.push_back(1);
+        return c;
+    }
+};
+
+void test_chunked(const big_uint & x, int base, size_t chunk_size) {
+    recording_buf buf;
+    ostream os(&buf);
+    write_chunked(os, x, base, chunk_size);
+    assert(buf.text == to_string(x, base));
+    assert(*max_element(buf.pieces.begin(), buf.pieces.end()) <= chunk_size);
+    assert(size_t(count(buf.pieces.begin(), buf.pieces.end(), chunk_size)) >=
+           buf.text.size() / chunk_size);
+}
+
+void test_chunked() {
+    for (size_t threshold : { 2, 30 }) {
+        big_uint::set_radix_threshold(threshold);
+        for (int base : { 2, 3, 8, 10, 16, 32, 36 }) {
+            for (size_t chunk_size : { 1, 7, 64, 1000 }) {
+                test_chunked(big_uint(), base, chunk_size);
+                test_chunked(big_uint(m), base, chunk_size);
+                for (size_t length : { 2, 5, 40, 300 }) {
+                    test_chunked(make_number(length, length + base), base, chunk_size);
+                }
+                // Long runs of zeros in the low parts.
+                big_uint p = big_uint(base).pow(2000);
+                test_chunked(p, base, chunk_size);
+                test_chunked(p + 1u, base, chunk_size);
+                test_chunked(p - 1u, base, chunk_size);
+            }
+        }
+    }
+    big_uint::set_radix_threshold(30);
+}
+
+void test_big_int() {
+    ostringstream os;
+    write_chunked(os, big_int(-255), 16);
+    write_chunked(os, big_int(0));
+    write_chunked(os, big_int("-123456789012345678901234567890"), 10, 4);
+    assert(os.str() == "-ff0-123456789012345678901234567890");
+}
+
+void test_file_descriptor() {
+    const char * path = "chunked_writer_tests.tmp";
+    big_uint x = make_number(500, 11);
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+    write_chunked(fd, x, 10, 100);
+    write_chunked(fd, -big_int(7), 2);
+    ::close(fd);
+    ifstream file(path);
+    string text{ istreambuf_iterator<char>(file), istreambuf_iterator<char>() };
+    assert(text == to_string(x) + "-111");
+    remove(path);
+
+    bool thrown = false;
+    try {
+        write_chunked(-1, x);
+    } catch (const system_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_stream_operator() {
+    big_uint x = make_number(20000, 3);
+    ostringstream os;
+    os << x;
+    assert(os.str() == to_string(x));
+    ostringstream hex_os;
+    hex_os << hex << uppercase << showbase << x;
+    string expected = to_string(x, 16);
+    transform(expected.begin(), expected.end(), expected.begin(), ::toupper);
+    assert(hex_os.str() == "0X" + expected);
+}
+
+int main() {
+    cout << "chunked_writer_tests.cpp\n";
+    test_chunked();
+    test_big_int();
+    test_file_descriptor();
+    test_stream_operator();
+    cout << "OK!\n";
+    return 0;
+}
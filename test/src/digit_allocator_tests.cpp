@@ -0,0 +1,90 @@
+#include "big_uint.hpp"
+#include "digit_allocator.hpp"
+#include "assert.hpp"
+
+#include <cassert>
+
+using namespace std;
+using namespace big;
+
+class counting_allocator : public digit_allocator {
+public:
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+    digit * allocate(size_t n) override {
+        ++allocations;
+        return heap_allocator().allocate(n);
+    }
+
+    void deallocate(digit * p, size_t n) override {
+        ++deallocations;
+        heap_allocator().deallocate(p, n);
+    }
+};
+
+void test_small_values_dont_allocate() {
+    counting_allocator alloc;
+    allocator_scope scope(alloc);
+    big_uint x;
+    big_uint y{ 1, 2, 3, 4 };
+    x += y;
+    x *= 2u;
+    assert(x == big_uint({ 2, 4, 6, 8 }));
+    assert(alloc.allocations == 0);
+}
+
+void test_allocator_scope() {
+    counting_allocator alloc;
+    assert(&default_allocator() == &pool_allocator());
+    {
+        allocator_scope scope(alloc);
+        assert(&default_allocator() == &alloc);
+        big_uint x{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        assert(x.digits().size() == 9);
+        assert(alloc.allocations == 1);
+    }
+    assert(&default_allocator() == &pool_allocator());
+    assert(alloc.allocations == alloc.deallocations);
+}
+
+void test_buffer_returns_to_its_allocator() {
+    counting_allocator alloc;
+    digit_vector d(alloc);
+    d.resize(100);
+    big_uint x(move(d));
+    big_uint y = x;
+    x = y;
+    assert(alloc.allocations == 1);
+    x = big_uint();
+    assert(alloc.deallocations == 1);
+}
+
+void test_pool_recycles_buffers() {
+    digit_allocator & pool = pool_allocator();
+    assert(pool.round_up(9) == 16);
+    assert(pool.round_up(16) == 16);
+    digit * p = pool.allocate(pool.round_up(100));
+    pool.deallocate(p, pool.round_up(100));
+    digit * q = pool.allocate(pool.round_up(120));
+    assert(p == q);
+    pool.deallocate(q, pool.round_up(120));
+}
+
+void test_pool_arithmetic() {
+    big_uint x{ "3243267419327147878943294639276321321321321432432432" };
+    big_uint y = x.pow(20);
+    assert(y / x.pow(19) == x);
+    assert(y % x == 0u);
+}
+
+int main() {
+    cout << "digit_allocator_tests.cpp\n";
+    test_small_values_dont_allocate();
+    test_allocator_scope();
+    test_buffer_returns_to_its_allocator();
+    test_pool_recycles_buffers();
+    test_pool_arithmetic();
+    cout << "OK!\n";
+    return 0;
+}
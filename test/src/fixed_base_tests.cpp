@@ -0,0 +1,80 @@
+#include "fixed_base.hpp"
+#include "assert.hpp"
+#include "numbers.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+using namespace std;
+using namespace big;
+
+void test_small() {
+    fixed_base f(big_uint(3), big_uint(1000), 16);
+    assert(f.base() == 3u);
+    assert(f.modulus() == 1000u);
+    assert(f.exponent_bits() == 16);
+    assert(f.pow(big_uint()) == 1u);
+    assert(f.pow(big_uint(1)) == 3u);
+    assert(f.pow(big_uint(7)) == 187u);
+    assert(f.pow(big_uint(100)) == big_uint(3).pow_mod(big_uint(100), big_uint(1000)));
+
+    fixed_base one(big_uint(5), big_uint(1), 8);
+    assert(one.pow(big_uint()) == 0u);
+    assert(one.pow(big_uint(9)) == 0u);
+
+    fixed_base zero(big_uint(), big_uint(101), 8);
+    assert(zero.pow(big_uint()) == 1u);
+    assert(zero.pow(big_uint(4)) == 0u);
+
+    fixed_base reduced(big_uint(1005), big_uint(1000), 8);
+    assert(reduced.base() == 5u);
+    assert(reduced.pow(big_uint(2)) == 25u);
+}
+
+void test_against_pow_mod() {
+    for (size_t length : { 1, 3, 8, 17 }) {
+        big_uint odd = make_number(length, digit(length));
+        if (odd % 2u == 0u) ++odd;
+        big_uint even = odd + 1u;
+        for (const big_uint & m : { odd, even }) {
+            big_uint g = make_number(length, 7);
+            size_t bits = 64 * length;
+            for (size_t table_bytes : { size_t(0), size_t(1000), default_table_bytes }) {
+                fixed_base f(g, m, bits, table_bytes);
+                assert(f.table_size() >= 1);
+                assert(f.table_size() * length * sizeof(digit) <= max(table_bytes,
+                                                                     length * sizeof(digit)));
+                for (digit seed : { 1u, 2u, 3u }) {
+                    big_uint e = make_number(bits / 64 * seed, seed) % big_uint(2).pow(bits);
+                    assert(f.pow(e) == g.pow_mod(e, m));
+                }
+                // Past the table.
+                big_uint e = make_number(3 * length, 11);
+                assert(f.pow(e) == g.pow_mod(e, m));
+                assert(f.pow(big_uint(2).pow(bits) - 1u) ==
+                       g.pow_mod(big_uint(2).pow(bits) - 1u, m));
+            }
+        }
+    }
+}
+
+void test_shared_table() {
+    big_uint p = big_uint(2).pow(127) - 1u;
+    fixed_base f(big_uint(3), p, 127, 4096);
+    fixed_base g = f;
+    assert(&f.modulus() == &g.modulus());
+    // Fermat's little theorem.
+    assert(g.pow(p - 1u) == 1u);
+    vector<fixed_base> copies(2, f);
+    assert(copies[1].pow(p) == 3u);
+}
+
+int main() {
+    cout << "fixed_base_tests.cpp\n";
+    test_small();
+    test_against_pow_mod();
+    test_shared_table();
+    cout << "OK!\n";
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "mod_int.hpp"
+#include "assert.hpp"
+#include "numbers.hpp"
+
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace big;
+
+big_uint make_odd(size_t length, digit seed) {
+    big_uint m = make_number(length, seed);
+    return m % 2u == 0u ? m + 1u : m;
+}
+
+void test_conversion() {
+    mod_int::context c(big_uint("1000000007"));
+    assert(c.modulus() == big_uint("1000000007"));
+    assert(mod_int(c, big_uint()).value() == 0u);
+    assert(mod_int(c, big_uint(5)).value() == 5u);
+    assert(mod_int(c, big_uint("1000000012")).value() == 5u);
+    assert(mod_int(c, big_uint("1000000007")).value() == 0u);
+
+    for (size_t length : { 1, 2, 5, 30, 70 }) {
+        big_uint m = make_odd(length, digit(length));
+        mod_int::context ctx(m);
+        for (size_t xl : { size_t(1), length, 2 * length + 3 }) {
+            big_uint x = make_number(xl, digit(7 * xl));
+            assert(mod_int(ctx, x).value() == x % m);
+        }
+    }
+}
+
+void test_arithmetic() {
+    for (size_t length : { 1, 2, 3, 8, 25, 60 }) {
+        big_uint m = make_odd(length, digit(3 * length + 1));
+        mod_int::context c(m);
+        big_uint a = make_number(length, 11) % m;
+        big_uint b = make_number(length + 1, 13) % m;
+        mod_int x(c, a), y(c, b);
+
+        assert((x + y).value() == (a + b) % m);
+        assert((x - y).value() == (a + m - b) % m);
+        assert((y - x).value() == (b + m - a) % m);
+        assert((x * y).value() == a * b % m);
+        assert(x.square().value() == a * a % m);
+        assert((-x).value() == (m - a) % m);
+        assert((x - x).value() == 0u);
+        assert(-mod_int(c, big_uint()) == mod_int(c, big_uint()));
+
+        // A chain stays in Montgomery form and agrees with plain arithmetic.
+        mod_int z = x;
+        big_uint r = a;
+        for (int i = 0; i < 20; ++i) {
+            z = z * y + x;
+            r = (r * b + a) % m;
+            z -= y.square();
+            r = (r + m - b * b % m) % m;
+        }
+        assert(z.value() == r);
+        assert(z == mod_int(c, r));
+        assert(z != z + mod_int(c, big_uint(1)));
+    }
+}
+
+void test_pow() {
+    big_uint m = make_odd(12, 5);
+    mod_int::context c(m);
+    big_uint a = make_number(12, 17);
+    mod_int x(c, a);
+    assert(x.pow(big_uint()).value() == 1u);
+    assert(x.pow(big_uint(1)).value() == a % m);
+    assert(x.pow(big_uint(3)).value() == a * a * a % m);
+    big_uint e = make_number(4, 23);
+    assert(x.pow(e).value() == a.pow_mod(e, m));
+
+    // Fermat's little theorem modulo the Mersenne prime 2^127 - 1.
+    big_uint p = big_uint(2).pow(127) - 1u;
+    mod_int::context f(p);
+    mod_int y(f, make_number(7, 29));
+    assert(y.pow(p - 1u).value() == 1u);
+}
+
+void test_inverse() {
+    big_uint p = big_uint(2).pow(127) - 1u;
+    mod_int::context f(p);
+    for (digit seed : { 1u, 2u, 3u, 4u }) {
+        mod_int x(f, make_number(seed + 1, seed));
+        assert((x * x.inverse()).value() == 1u);
+    }
+    assert(mod_int(f, big_uint(1)).inverse().value() == 1u);
+    assert(mod_int(f, p - 1u).inverse().value() == p - 1u);
+
+    mod_int::context c(big_uint(15));
+    assert((mod_int(c, big_uint(7)).inverse()).value() == 13u);
+    for (digit v : { 0u, 3u, 5u, 6u, 10u }) {
+        bool thrown = false;
+        try {
+            mod_int(c, big_uint(v)).inverse();
+        } catch (const domain_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+void test_shared_context() {
+    big_uint m = make_odd(4, 41);
+    mod_int x(mod_int::context(m), big_uint(2));
+    // The context outlives the object it was built from.
+    mod_int y(x.get_context(), big_uint(3));
+    assert((x * y).value() == 6u % m);
+    assert(&x.modulus() == &y.modulus());
+    vector<mod_int> values(3, x);
+    for (mod_int & v : values) v *= y;
+    assert(values[2].value() == 6u % m);
+}
+
+int main() {
+    cout << "mod_int_tests.cpp\n";
+    test_conversion();
+    test_arithmetic();
+    test_pow();
+    test_inverse();
+    test_shared_context();
+    cout << "OK!\n";
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "multi_pow.hpp"
+#include "assert.hpp"
+#include "numbers.hpp"
+
+#include <cassert>
+#include <vector>
+
+using namespace std;
+using namespace big;
+
+big_uint reference(const vector<big_uint> & g, const vector<big_uint> & e, const big_uint & m) {
+    big_uint r = big_uint(1) % m;
+    for (size_t i = 0; i < g.size(); ++i) r = r * g[i].pow_mod(e[i], m) % m;
+    return r;
+}
+
+void test_small() {
+    big_uint m(1000);
+    assert(multi_pow({}, {}, m) == 1u);
+    assert(multi_pow({}, {}, big_uint(1)) == 0u);
+    assert(multi_pow({ big_uint(3) }, { big_uint(7) }, m) == 187u);
+    assert(multi_pow({ big_uint(2), big_uint(3) }, { big_uint(10), big_uint(2) }, m) == 216u);
+    assert(multi_pow({ big_uint(2), big_uint(3) }, { big_uint(), big_uint() }, big_uint(7)) == 1u);
+    assert(multi_pow({ big_uint(), big_uint(3) }, { big_uint(1), big_uint(4) }, big_uint(7)) == 0u);
+    assert(multi_pow({ big_uint(1009) }, { big_uint(2) }, big_uint(1001)) == 64u);
+    assert(multi_pow({ big_uint(5) }, { big_uint(3) }, big_uint(1)) == 0u);
+
+    big_uint g[] = { big_uint(2), big_uint(5) };
+    big_uint e[] = { big_uint(3), big_uint(2) };
+    assert(multi_pow(g, e, 2, big_uint(101)) == 200u % 101u);
+    assert(multi_pow(g, e, 1, big_uint(101)) == 8u);
+}
+
+// k bases with exponents of up to e_length digits, some of them zero.
+void check(size_t k, size_t m_length, size_t e_length) {
+    big_uint odd = make_number(m_length, digit(k + m_length));
+    if (odd % 2u == 0u) ++odd;
+    for (const big_uint & m : { odd, odd + 1u }) {
+        vector<big_uint> g, e;
+        for (size_t i = 0; i < k; ++i) {
+            g.push_back(make_number(m_length + i % 2, digit(3 * i + 1)));
+            e.push_back(i % 7 == 3 ? big_uint() : make_number(1 + i % e_length, digit(5 * i + 2)));
+        }
+        assert(multi_pow(g, e, m) == reference(g, e, m));
+    }
+}
+
+void test_against_pow_mod() {
+    // Straus.
+    check(2, 4, 4);
+    check(5, 8, 8);
+    check(16, 3, 2);
+    // Pippenger with short exponents.
+    check(200, 2, 1);
+    check(600, 4, 2);
+}
+
+int main() {
+    cout << "multi_pow_tests.cpp\n";
+    test_small();
+    test_against_pow_mod();
+    cout << "OK!\n";
+    return 0;
+}